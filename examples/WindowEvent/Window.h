@@ -2,7 +2,7 @@
 
 class WindowEvent;    // Forward Declaration of event class if necessary
 
-class Window : public tSubject<const WindowEvent&>
+class Window : public tSubject<const WindowEvent&, 4>   // Windows rarely have more than a few listeners
 {
 public:
     Window();
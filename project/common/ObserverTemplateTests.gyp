@@ -10,6 +10,14 @@
 			'../../tObserverTests.cc',
 			'../../tSubjectTests.cc',
 			'../../tObserver.h',
+			'../../tKeyedSubject.h',
+			'../../tConflatingSubject.h',
+			'../../tConcurrentSubject.h',
+			'../../tAsyncSubject.h',
+			'../../tParallelSubject.h',
+			'../../tMailboxObserver.h',
+			'../../tVariantSubject.h',
+			'../../tAwaitableSubject.h',
 		],	# sources
 
 		'include_dirs': [
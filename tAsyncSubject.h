@@ -0,0 +1,363 @@
+/*
+ Observer Template (C++) by TJ Grant (tjgrant@tatewake.com)
+
+ tAsyncSubject: a subject whose notify() queues messages for delivery on another thread.
+
+ //--
+
+ Copyright (c) 2011-02-01 TJ Grant (tjgrant@tatewake.com)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#pragma once
+
+#include "tObserver.h"
+
+#if __cplusplus >= 201103L
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#endif
+
+#if __cplusplus >= 201103L
+// A subject whose notify() only queues the message and returns, so producers never wait on observers. Any thread may
+// notify, emplaceNotify or notifyBatch; messages go into a bounded lock-free ring (Vyukov's sequence-numbered cells)
+// and are delivered, in order, by whichever single thread calls drain(), or by the dispatcher thread start() launches.
+// The dispatcher sleeps on a condition variable once the ring has stayed empty for a while; producers only take its
+// lock to wake it. Attach and detach only where nothing is draining: before start(), after stop(), or from within
+// update(). An update() may delete the subject only when it was reached through a drain() the owner called, not from
+// the dispatcher thread. The tSubject it's built on is private, so there's no way to deliver around the ring.
+template<class T>
+class tAsyncSubject
+: private tSubject<T>
+{
+private:
+    typedef tSubject<T>                         BaseType;
+    typedef typename tMessageParam<T>::Type     ParamType;
+    typedef typename tMessageValue<T>::Type     ValueType;
+
+    struct Cell
+    {
+        std::atomic<size_t>     mSequence;
+        alignas(ValueType) unsigned char mStorage[sizeof(ValueType)];
+    };
+
+private:
+    Cell*                       mCells;
+    size_t                      mMask;
+    std::atomic<size_t>         mEnqueuePos;
+    char                        mPad[64];           // keeps producers and the consumer off one cache line
+    size_t                      mDequeuePos;
+    std::atomic<bool>           mStopping;
+    std::atomic<bool>           mSleeping;          // the dispatcher is waiting, or about to, on mWake
+    std::mutex                  mWakeMutex;
+    std::condition_variable     mWake;
+    std::thread                 mDispatcher;
+
+private:
+    template<class... Args> bool Enqueue(Args&&... args);
+    bool IsReady() const;
+    void WakeDispatcher();
+    void DispatchLoop();
+
+public:
+    explicit tAsyncSubject(size_t capacity = 1024);
+    tAsyncSubject(const tAsyncSubject& other) = delete;
+    virtual ~tAsyncSubject();
+
+public:
+    tAsyncSubject& operator=(const tAsyncSubject& other) = delete;
+
+public:
+    using BaseType::attach;
+    using BaseType::detach;
+    using BaseType::detachAll;
+    using BaseType::connect;
+    using BaseType::disconnect;
+    using BaseType::isAttached;
+    using BaseType::setAllocator;
+
+    // Returns false, dropping the message, when the ring is full
+    bool notify(ParamType msg);
+    template<class... Args> bool emplaceNotify(Args&&... args);
+
+    // Queues from the front until the ring is full; returns how many went in, so msgs + that is where to pick up again
+    size_t notifyBatch(typename tMessageBatch<T>::Type msgs, size_t count);
+
+    size_t drain(size_t maxMessages = size_t(-1));
+
+    void start();
+    void stop();
+};
+#endif
+
+#if __cplusplus >= 201103L
+template<class T>
+tAsyncSubject<T>::tAsyncSubject(size_t capacity)
+:   mCells(NULL),
+mMask(0),
+mEnqueuePos(0),
+mDequeuePos(0),
+mStopping(false),
+mSleeping(false)
+{
+    size_t size = 2;
+
+    while (size < capacity)
+    {
+        size *= 2;
+    }
+
+    mCells = new Cell[size];
+    mMask = size - 1;
+
+    // A cell whose sequence equals the enqueue position is free to write; position + 1 means it's ready to read
+    for(size_t i = 0; i < size; i++)
+    {
+        mCells[i].mSequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template<class T>
+tAsyncSubject<T>::~tAsyncSubject()
+{
+    stop();
+
+    // Whatever's left is destroyed undelivered
+    for(;;)
+    {
+        Cell* cell = &mCells[mDequeuePos & mMask];
+
+        if (cell->mSequence.load(std::memory_order_acquire) != mDequeuePos + 1)
+        {
+            break;
+        }
+
+        reinterpret_cast<ValueType*>(cell->mStorage)->~ValueType();
+        mDequeuePos++;
+    }
+
+    delete[] mCells;
+}
+
+template<class T>
+template<class... Args>
+bool tAsyncSubject<T>::Enqueue(Args&&... args)
+{
+    size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+
+    for(;;)
+    {
+        cell = &mCells[pos & mMask];
+
+        size_t sequence = cell->mSequence.load(std::memory_order_acquire);
+        ptrdiff_t difference = static_cast<ptrdiff_t>(sequence) - static_cast<ptrdiff_t>(pos);
+
+        if (difference == 0)
+        {
+            if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            // Still holding a message from a lap ago; the ring is full
+            return false;
+        }
+        else
+        {
+            pos = mEnqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    new (cell->mStorage) ValueType(std::forward<Args>(args)...);
+    // Sequentially consistent, as is the dispatcher's last look before it sleeps; see WakeDispatcher
+    cell->mSequence.store(pos + 1, std::memory_order_seq_cst);
+
+    return true;
+}
+
+template<class T>
+bool tAsyncSubject<T>::IsReady() const
+{
+    return mCells[mDequeuePos & mMask].mSequence.load(std::memory_order_seq_cst) == mDequeuePos + 1;
+}
+
+template<class T>
+void tAsyncSubject<T>::WakeDispatcher()
+{
+    // The message was published before this load, and the dispatcher announces itself before its last look at the
+    // ring, all sequentially consistent: either it sees the message, or this sees it going to sleep
+    if (mSleeping.load(std::memory_order_seq_cst))
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mWake.notify_one();
+    }
+}
+
+template<class T>
+bool tAsyncSubject<T>::notify(ParamType msg)
+{
+    if (!Enqueue(msg))
+    {
+        return false;
+    }
+
+    WakeDispatcher();
+
+    return true;
+}
+
+template<class T>
+template<class... Args>
+bool tAsyncSubject<T>::emplaceNotify(Args&&... args)
+{
+    // Built straight into its cell, so the only copies are those observers taking it by value make
+    if (!Enqueue(std::forward<Args>(args)...))
+    {
+        return false;
+    }
+
+    WakeDispatcher();
+
+    return true;
+}
+
+template<class T>
+size_t tAsyncSubject<T>::notifyBatch(typename tMessageBatch<T>::Type msgs, size_t count)
+{
+    size_t queued = 0;
+
+    while (queued < count && Enqueue(msgs[queued]))
+    {
+        queued++;
+    }
+
+    if (queued)
+    {
+        WakeDispatcher();
+    }
+
+    return queued;
+}
+
+template<class T>
+size_t tAsyncSubject<T>::drain(size_t maxMessages)
+{
+    // Not from within update(): this drain is already under way
+    assert(!this->mSubjectDeletedPtr);
+
+    if (this->mSubjectDeletedPtr)
+    {
+        return 0;
+    }
+
+    tDeletionGuard guard(this->mSubjectDeletedPtr);
+    const bool& subjectDeleted = guard.deleted();
+    size_t count = 0;
+
+    while (count < maxMessages && IsReady())
+    {
+        Cell* cell = &mCells[mDequeuePos & mMask];
+
+        // Delivered straight out of the cell, which producers leave alone until it's handed back below
+        ValueType* msg = reinterpret_cast<ValueType*>(cell->mStorage);
+
+        BaseType::notify(*msg);
+
+        // The destructor has already disposed of this message along with the rest of the ring
+        if (subjectDeleted)
+        {
+            return count + 1;
+        }
+
+        msg->~ValueType();
+        cell->mSequence.store(mDequeuePos + mMask + 1, std::memory_order_release);
+        mDequeuePos++;
+        count++;
+    }
+
+    return count;
+}
+
+template<class T>
+void tAsyncSubject<T>::DispatchLoop()
+{
+    size_t idle = 0;
+
+    while (!mStopping.load(std::memory_order_acquire))
+    {
+        if (drain())
+        {
+            idle = 0;
+        }
+        else if (++idle < 64)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            std::unique_lock<std::mutex> lock(mWakeMutex);
+
+            // Announced before the last look at the ring; see WakeDispatcher
+            mSleeping.store(true, std::memory_order_seq_cst);
+
+            while (!mStopping.load(std::memory_order_acquire) && !IsReady())
+            {
+                mWake.wait(lock);
+            }
+
+            mSleeping.store(false, std::memory_order_relaxed);
+            idle = 0;
+        }
+    }
+
+    drain();
+}
+
+template<class T>
+void tAsyncSubject<T>::start()
+{
+    assert(!mDispatcher.joinable());
+
+    if (!mDispatcher.joinable())
+    {
+        mStopping.store(false);
+        mDispatcher = std::thread(&tAsyncSubject::DispatchLoop, this);
+    }
+}
+
+template<class T>
+void tAsyncSubject<T>::stop()
+{
+    // Messages queued before stop() are delivered before it returns
+    if (mDispatcher.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mWakeMutex);
+            mStopping.store(true, std::memory_order_release);
+        }
+
+        mWake.notify_one();
+        mDispatcher.join();
+    }
+}
+#endif
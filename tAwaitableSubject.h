@@ -0,0 +1,320 @@
+/*
+ Observer Template (C++) by TJ Grant (tjgrant@tatewake.com)
+
+ tAwaitableSubject: a subject C++20 coroutines can co_await.
+
+ //--
+
+ Copyright (c) 2011-02-01 TJ Grant (tjgrant@tatewake.com)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#pragma once
+
+#include "tObserver.h"
+
+#if __cplusplus >= 202002L
+#include <coroutine>
+#include <vector>
+#endif
+
+#if __cplusplus >= 202002L
+// A subject coroutines can co_await. Each consumer reads through a Cursor of its own, and co_await cursor.next()
+// yields the next message after the last one it read; a consumer with nothing to read is suspended and then resumed
+// directly from within the notify pass, after the subject's observers and callables, in the order they started
+// waiting. That holds however the message arrives: through a tSubject<T>& too, or from the nested notify queue. A
+// consumer that notifies from within its resume is nested, just as an observer's update() would be.
+// The last `capacity` messages are kept in a ring for consumers that weren't waiting; one that falls further behind
+// skips ahead, and counts what it skipped in missed(). An observer or a resumed consumer may delete the subject; any
+// consumer still waiting then is never resumed, and must be destroyed by its owner without touching the subject again.
+template<class T>
+class tAwaitableSubject
+: public tSubject<T>
+{
+private:
+    typedef tSubject<T>                         BaseType;
+    typedef typename tMessageParam<T>::Type     ParamType;
+    typedef typename tMessageValue<T>::Type     ValueType;
+
+public:
+    class Cursor;
+
+    class Awaiter
+    {
+    private:
+        Cursor*                     mCursor;
+        std::coroutine_handle<>     mHandle;
+        Awaiter**                   mListHead;      // non-NULL while linked into one of the subject's lists
+        Awaiter**                   mListTail;
+        Awaiter*                    mPrev;
+        Awaiter*                    mNext;
+
+    private:
+        void Link(Awaiter** head, Awaiter** tail);
+        void Unlink();
+
+    public:
+        explicit Awaiter(Cursor* cursor);
+        Awaiter(const Awaiter& other) = delete;
+        ~Awaiter();
+
+    public:
+        Awaiter& operator=(const Awaiter& other) = delete;
+
+    public:
+        bool await_ready();
+        void await_suspend(std::coroutine_handle<> handle);
+        ValueType await_resume();
+
+        friend class tAwaitableSubject;
+    };
+
+    class Cursor
+    {
+    private:
+        tAwaitableSubject*  mSubject;
+        unsigned long long  mPosition;
+        size_t              mMissed;
+
+    private:
+        bool CatchUp();
+
+    public:
+        explicit Cursor(tAwaitableSubject& subject);   // reads from the next message notified
+
+    public:
+        Awaiter next();
+        size_t missed() const       { return mMissed; }
+
+        friend class Awaiter;
+    };
+
+private:
+    std::vector<ValueType>  mRing;
+    size_t                  mCapacity;
+    unsigned long long      mWritten;
+    Awaiter*                mWaitingHead;
+    Awaiter*                mWaitingTail;
+    Awaiter*                mResumingHead;
+    Awaiter*                mResumingTail;
+
+private:
+    static void Abandon(Awaiter* head);
+
+protected:
+    virtual void Dispatch(ParamType msg, const bool& subjectDeleted);
+
+    // A message at a time, so that waiting consumers see every one of them
+    virtual void DispatchBatch(typename tMessageBatch<T>::Type msgs, size_t count, const bool& subjectDeleted);
+
+public:
+    explicit tAwaitableSubject(size_t capacity = 64);
+    tAwaitableSubject(const tAwaitableSubject& other) = delete;
+    virtual ~tAwaitableSubject();
+
+public:
+    tAwaitableSubject& operator=(const tAwaitableSubject& other) = delete;
+};
+#endif
+
+#if __cplusplus >= 202002L
+template<class T>
+void tAwaitableSubject<T>::Awaiter::Link(Awaiter** head, Awaiter** tail)
+{
+    mListHead = head;
+    mListTail = tail;
+    mPrev = *tail;
+    mNext = NULL;
+
+    (mPrev ? mPrev->mNext : *head) = this;
+    *tail = this;
+}
+
+template<class T>
+void tAwaitableSubject<T>::Awaiter::Unlink()
+{
+    if (mListHead)
+    {
+        (mPrev ? mPrev->mNext : *mListHead) = mNext;
+        (mNext ? mNext->mPrev : *mListTail) = mPrev;
+
+        mListHead = mListTail = NULL;
+        mPrev = mNext = NULL;
+    }
+}
+
+template<class T>
+tAwaitableSubject<T>::Awaiter::Awaiter(Cursor* cursor)
+:   mCursor(cursor),
+mListHead(NULL),
+mListTail(NULL),
+mPrev(NULL),
+mNext(NULL)
+{
+}
+
+template<class T>
+tAwaitableSubject<T>::Awaiter::~Awaiter()
+{
+    // A coroutine destroyed while suspended takes itself off the list it was waiting (or about to be resumed) on
+    Unlink();
+}
+
+template<class T>
+bool tAwaitableSubject<T>::Awaiter::await_ready()
+{
+    return mCursor->CatchUp();
+}
+
+template<class T>
+void tAwaitableSubject<T>::Awaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    tAwaitableSubject* subject = mCursor->mSubject;
+
+    mHandle = handle;
+    Link(&subject->mWaitingHead, &subject->mWaitingTail);
+}
+
+template<class T>
+typename tAwaitableSubject<T>::ValueType tAwaitableSubject<T>::Awaiter::await_resume()
+{
+    mCursor->CatchUp();
+
+    const tAwaitableSubject* subject = mCursor->mSubject;
+
+    return subject->mRing[mCursor->mPosition++ % subject->mCapacity];
+}
+
+template<class T>
+tAwaitableSubject<T>::Cursor::Cursor(tAwaitableSubject& subject)
+:   mSubject(&subject),
+mPosition(subject.mWritten),
+mMissed(0)
+{
+}
+
+template<class T>
+bool tAwaitableSubject<T>::Cursor::CatchUp()
+{
+    // Anything more than a ring behind has been overwritten
+    if (mSubject->mWritten - mPosition > mSubject->mCapacity)
+    {
+        mMissed += mSubject->mWritten - mSubject->mCapacity - mPosition;
+        mPosition = mSubject->mWritten - mSubject->mCapacity;
+    }
+
+    return mPosition != mSubject->mWritten;
+}
+
+template<class T>
+typename tAwaitableSubject<T>::Awaiter tAwaitableSubject<T>::Cursor::next()
+{
+    return Awaiter(this);
+}
+
+template<class T>
+tAwaitableSubject<T>::tAwaitableSubject(size_t capacity)
+:   mCapacity(capacity ? capacity : 1),
+mWritten(0),
+mWaitingHead(NULL),
+mWaitingTail(NULL),
+mResumingHead(NULL),
+mResumingTail(NULL)
+{
+    mRing.reserve(mCapacity);
+}
+
+template<class T>
+tAwaitableSubject<T>::~tAwaitableSubject()
+{
+    Abandon(mWaitingHead);
+    Abandon(mResumingHead);
+}
+
+template<class T>
+void tAwaitableSubject<T>::Abandon(Awaiter* head)
+{
+    // Cut loose rather than unlinked one by one, so an awaiter destroyed later doesn't reach back into this subject
+    while (head)
+    {
+        Awaiter* next = head->mNext;
+
+        head->mListHead = head->mListTail = NULL;
+        head->mPrev = head->mNext = NULL;
+        head = next;
+    }
+}
+
+template<class T>
+void tAwaitableSubject<T>::Dispatch(ParamType msg, const bool& subjectDeleted)
+{
+    BaseType::Dispatch(msg, subjectDeleted);
+
+    if (subjectDeleted)
+    {
+        return;
+    }
+
+    if (mRing.size() < mCapacity)
+    {
+        mRing.push_back(msg);
+    }
+    else
+    {
+        mRing[mWritten % mCapacity] = msg;
+    }
+
+    mWritten++;
+
+    // Everyone waiting now gets this message; anyone who starts waiting from within a resume waits for the next one
+    while (mWaitingHead)
+    {
+        Awaiter* awaiter = mWaitingHead;
+
+        awaiter->Unlink();
+        awaiter->Link(&mResumingHead, &mResumingTail);
+    }
+
+    while (mResumingHead)
+    {
+        Awaiter* awaiter = mResumingHead;
+
+        awaiter->Unlink();
+        awaiter->mHandle.resume();
+
+        if (subjectDeleted)
+        {
+            return;
+        }
+    }
+}
+
+template<class T>
+void tAwaitableSubject<T>::DispatchBatch(typename tMessageBatch<T>::Type msgs, size_t count, const bool& subjectDeleted)
+{
+    for(size_t i = 0; i < count; i++)
+    {
+        Dispatch(msgs[i], subjectDeleted);
+
+        if (subjectDeleted)
+        {
+            return;
+        }
+    }
+}
+#endif
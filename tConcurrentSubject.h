@@ -0,0 +1,222 @@
+/*
+ Observer Template (C++) by TJ Grant (tjgrant@tatewake.com)
+
+ tConcurrentSubject: a subject that may be notified from several threads at once without a lock.
+
+ //--
+
+ Copyright (c) 2011-02-01 TJ Grant (tjgrant@tatewake.com)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#pragma once
+
+#include "tObserver.h"
+
+#if __cplusplus >= 201103L
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+#if __cplusplus >= 201103L
+// A subject that may be notified from any number of threads at once without a lock. notify() reads an immutable
+// snapshot of the observer list; attach and detach (serialized by a mutex) publish a new snapshot and free the old
+// one once no notify can still be reading it, found by counting readers against a two-phase epoch.
+// Unlike tSubject, observers aren't told about the subject: detach them before they're destroyed. Once detach()
+// returns, no notify is still calling that observer. Neither may be called from within update().
+template<class T>
+class tConcurrentSubject
+{
+private:
+    typedef tObserver<T>                        ObserverType;
+    typedef typename tMessageParam<T>::Type     ParamType;
+
+    struct Snapshot
+    {
+        std::vector<ObserverType*>  mObservers;
+    };
+
+    // Readers of each epoch parity, kept apart so the two counters don't share a cache line
+    struct alignas(64) ReaderCount
+    {
+        std::atomic<size_t>         mCount;
+    };
+
+private:
+    std::atomic<Snapshot*>      mSnapshot;
+    std::atomic<unsigned>       mEpoch;
+    ReaderCount                 mReaders[2];
+    std::mutex                  mWriteMutex;
+
+private:
+    void Publish(Snapshot* snapshot);
+    void WaitForReaders();
+
+public:
+    tConcurrentSubject();
+    tConcurrentSubject(const tConcurrentSubject& other) = delete;
+    ~tConcurrentSubject();
+
+public:
+    tConcurrentSubject& operator=(const tConcurrentSubject& other) = delete;
+
+public:
+    void attach(ObserverType* newOb);
+    void detach(ObserverType* newOb);
+    void detachAll();
+
+    void notify(ParamType msg);
+
+    bool isAttached(const ObserverType* ob);
+};
+#endif
+
+#if __cplusplus >= 201103L
+template<class T>
+void tConcurrentSubject<T>::Publish(Snapshot* snapshot)
+{
+    Snapshot* oldSnapshot = mSnapshot.exchange(snapshot);
+
+    WaitForReaders();
+
+    delete oldSnapshot;
+}
+
+template<class T>
+void tConcurrentSubject<T>::WaitForReaders()
+{
+    // A reader counts itself in the current parity before loading the snapshot. One that read the parity just before
+    // a flip may still count itself in the old one after we've seen it drain, but it will then load the new snapshot;
+    // so each parity is flipped away from and drained in turn, and then every reader of the old snapshot is gone.
+    for(int phase = 0; phase < 2; phase++)
+    {
+        unsigned parity = mEpoch.fetch_add(1) & 1;
+
+        while (mReaders[parity].mCount.load() != 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+template<class T>
+tConcurrentSubject<T>::tConcurrentSubject()
+:   mSnapshot(nullptr),
+mEpoch(0)
+{
+    mReaders[0].mCount.store(0);
+    mReaders[1].mCount.store(0);
+}
+
+template<class T>
+tConcurrentSubject<T>::~tConcurrentSubject()
+{
+    assert(mReaders[0].mCount.load() == 0 && mReaders[1].mCount.load() == 0);
+
+    delete mSnapshot.load();
+}
+
+template<class T>
+void tConcurrentSubject<T>::attach(ObserverType* newOb)
+{
+    assert(newOb);
+
+    if (newOb)
+    {
+        std::lock_guard<std::mutex> lock(mWriteMutex);
+
+        Snapshot* oldSnapshot = mSnapshot.load();
+        Snapshot* snapshot = oldSnapshot ? new Snapshot(*oldSnapshot) : new Snapshot();
+
+        assert(std::find(snapshot->mObservers.begin(), snapshot->mObservers.end(), newOb) == snapshot->mObservers.end());
+
+        snapshot->mObservers.push_back(newOb);
+
+        Publish(snapshot);
+    }
+}
+
+template<class T>
+void tConcurrentSubject<T>::detach(ObserverType* newOb)
+{
+    std::lock_guard<std::mutex> lock(mWriteMutex);
+
+    const Snapshot* oldSnapshot = mSnapshot.load();
+
+    assert(oldSnapshot);
+
+    if (oldSnapshot)
+    {
+        typename std::vector<ObserverType*>::const_iterator iter =
+            std::find(oldSnapshot->mObservers.begin(), oldSnapshot->mObservers.end(), newOb);
+
+        assert(iter != oldSnapshot->mObservers.end());
+
+        if (iter != oldSnapshot->mObservers.end())
+        {
+            Snapshot* snapshot = new Snapshot();
+
+            snapshot->mObservers.reserve(oldSnapshot->mObservers.size() - 1);
+            snapshot->mObservers.insert(snapshot->mObservers.end(), oldSnapshot->mObservers.begin(), iter);
+            snapshot->mObservers.insert(snapshot->mObservers.end(), iter + 1, oldSnapshot->mObservers.end());
+
+            Publish(snapshot);
+        }
+    }
+}
+
+template<class T>
+void tConcurrentSubject<T>::detachAll()
+{
+    std::lock_guard<std::mutex> lock(mWriteMutex);
+
+    Publish(nullptr);
+}
+
+template<class T>
+void tConcurrentSubject<T>::notify(ParamType msg)
+{
+    unsigned parity = mEpoch.load() & 1;
+
+    mReaders[parity].mCount.fetch_add(1);
+
+    const Snapshot* snapshot = mSnapshot.load();
+
+    if (snapshot)
+    {
+        for(typename std::vector<ObserverType*>::const_iterator iter = snapshot->mObservers.begin(); iter != snapshot->mObservers.end(); iter++)
+        {
+            (*iter)->update(msg);
+        }
+    }
+
+    mReaders[parity].mCount.fetch_sub(1, std::memory_order_release);
+}
+
+template<class T>
+bool tConcurrentSubject<T>::isAttached(const ObserverType* ob)
+{
+    std::lock_guard<std::mutex> lock(mWriteMutex);
+
+    const Snapshot* snapshot = mSnapshot.load();
+
+    return snapshot && std::find(snapshot->mObservers.begin(), snapshot->mObservers.end(), ob) != snapshot->mObservers.end();
+}
+#endif
@@ -0,0 +1,179 @@
+/*
+ Observer Template (C++) by TJ Grant (tjgrant@tatewake.com)
+
+ tConflatingSubject: a subject that delivers only the latest message for each key.
+
+ //--
+
+ Copyright (c) 2011-02-01 TJ Grant (tjgrant@tatewake.com)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#pragma once
+
+#include "tObserver.h"
+
+#include <map>
+#include <vector>
+
+// A subject for bursty state messages where only the latest matters. notify() doesn't deliver, it just records the
+// message as pending for its key, KeyOf()(msg), replacing whatever was pending for that key; flush() then delivers
+// each pending message once, in the order their keys first became pending. Each key's slot is kept between flushes,
+// so a steady state of notify and flush does no allocation beyond copying messages. The tSubject it's built on is
+// private, so nothing can deliver around the conflation. An update() may delete the subject; flush() stops there.
+template<class T, class Key, class KeyOf>
+class tConflatingSubject
+: private tSubject<T>
+{
+private:
+    typedef tSubject<T>                         BaseType;
+    typedef typename tMessageParam<T>::Type     ParamType;
+    typedef typename tMessageValue<T>::Type     ValueType;
+    typedef std::map<Key, size_t>               SlotMap;
+
+private:
+    SlotMap                 mSlotIndices;
+    std::vector<ValueType>  mSlots;
+    std::vector<bool>       mSlotPending;
+    std::vector<size_t>     mPending;           // slot indices, in the order they became pending
+    std::vector<size_t>     mFlushing;
+    KeyOf                   mKeyOf;
+
+private:
+    tConflatingSubject(const tConflatingSubject& other);
+    tConflatingSubject& operator=(const tConflatingSubject& other);
+
+public:
+    explicit tConflatingSubject(const KeyOf& keyOf = KeyOf());
+
+public:
+    using BaseType::attach;
+    using BaseType::detach;
+    using BaseType::detachAll;
+    using BaseType::connect;
+    using BaseType::disconnect;
+    using BaseType::isAttached;
+    using BaseType::setAllocator;
+
+    void notify(ParamType msg);
+#if __cplusplus >= 201103L
+    template<class... Args> void emplaceNotify(Args&&... args);
+#endif
+    void notifyBatch(typename tMessageBatch<T>::Type msgs, size_t count);
+    void flush();
+
+    size_t pending() const      { return mPending.size(); }
+};
+
+template<class T, class Key, class KeyOf>
+tConflatingSubject<T, Key, KeyOf>::tConflatingSubject(const KeyOf& keyOf)
+:   mKeyOf(keyOf)
+{
+}
+
+template<class T, class Key, class KeyOf>
+void tConflatingSubject<T, Key, KeyOf>::notify(ParamType msg)
+{
+    Key key(mKeyOf(msg));
+    typename SlotMap::iterator iter = mSlotIndices.find(key);
+    size_t index;
+
+    if (iter == mSlotIndices.end())
+    {
+        index = mSlots.size();
+
+        mSlots.push_back(msg);
+        mSlotPending.push_back(false);
+        mSlotIndices.insert(typename SlotMap::value_type(key, index));
+    }
+    else
+    {
+        index = iter->second;
+        mSlots[index] = msg;
+    }
+
+    if (!mSlotPending[index])
+    {
+        mSlotPending[index] = true;
+        mPending.push_back(index);
+    }
+}
+
+#if __cplusplus >= 201103L
+template<class T, class Key, class KeyOf>
+template<class... Args>
+void tConflatingSubject<T, Key, KeyOf>::emplaceNotify(Args&&... args)
+{
+    ValueType msg(std::forward<Args>(args)...);
+
+    notify(msg);
+}
+#endif
+
+template<class T, class Key, class KeyOf>
+void tConflatingSubject<T, Key, KeyOf>::notifyBatch(typename tMessageBatch<T>::Type msgs, size_t count)
+{
+    // Conflated like any other messages; there's nothing to deliver until flush()
+    for(size_t i = 0; i < count; i++)
+    {
+        notify(msgs[i]);
+    }
+}
+
+template<class T, class Key, class KeyOf>
+void tConflatingSubject<T, Key, KeyOf>::flush()
+{
+    // Not from within update(): this flush is already under way
+    assert(!this->mSubjectDeletedPtr);
+
+    if (this->mSubjectDeletedPtr)
+    {
+        return;
+    }
+
+    tDeletionGuard guard(this->mSubjectDeletedPtr);
+    const bool& subjectDeleted = guard.deleted();
+
+    // A key notified from within update() after its delivery here is pending for the next flush; one not yet
+    // reached is simply delivered with the newer message
+    mFlushing.swap(mPending);
+
+    for(size_t i = 0; i < mFlushing.size(); i++)
+    {
+        size_t index = mFlushing[i];
+
+        if (!mSlotPending[index])
+        {
+            continue;
+        }
+
+        // Copied out, as update() may notify again and overwrite the slot, or grow mSlots under it
+        ValueType msg(mSlots[index]);
+
+        mSlotPending[index] = false;
+
+        BaseType::notify(msg);
+
+        if (subjectDeleted)
+        {
+            return;
+        }
+    }
+
+    mFlushing.clear();
+}
@@ -0,0 +1,137 @@
+/*
+ Observer Template (C++) by TJ Grant (tjgrant@tatewake.com)
+
+ tKeyedSubject: a subject that routes each message only to the observers of its key.
+
+ //--
+
+ Copyright (c) 2011-02-01 TJ Grant (tjgrant@tatewake.com)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#pragma once
+
+#include "tObserver.h"
+
+#include <map>
+
+// Routes each message only to the observers that asked for its key, KeyOf()(msg), rather than to every observer.
+// Each key gets its own tSubject<T> in a std::map, so notify() costs one lookup plus a pass over that key's observers,
+// and observers see a bucket as an ordinary subject (they detach themselves from it on destruction, and so on).
+template<class T, class Key, class KeyOf>
+class tKeyedSubject
+{
+private:
+    typedef tSubject<T>                         SubjectType;
+    typedef tObserver<T>                        ObserverType;
+    typedef typename tMessageParam<T>::Type     ParamType;
+    typedef std::map<Key, SubjectType>          BucketMap;
+
+private:
+    BucketMap   mBuckets;
+    KeyOf       mKeyOf;
+
+public:
+    explicit tKeyedSubject(const KeyOf& keyOf = KeyOf());
+
+public:
+    void attach(const Key& key, ObserverType* newOb);
+    void detach(const Key& key, ObserverType* newOb);
+    void detachAll();
+
+    tConnection connect(const Key& key, const tDelegate<T>& callback);
+    void disconnect(const Key& key, tConnection& connection);
+
+    void notify(ParamType msg);
+
+    bool isAttached(const Key& key, const ObserverType* ob) const;
+};
+
+template<class T, class Key, class KeyOf>
+tKeyedSubject<T, Key, KeyOf>::tKeyedSubject(const KeyOf& keyOf)
+:   mKeyOf(keyOf)
+{
+}
+
+template<class T, class Key, class KeyOf>
+void tKeyedSubject<T, Key, KeyOf>::attach(const Key& key, ObserverType* newOb)
+{
+    // Buckets are created on first use and kept; map nodes don't move, so observers can keep pointing at them
+    mBuckets[key].attach(newOb);
+}
+
+template<class T, class Key, class KeyOf>
+void tKeyedSubject<T, Key, KeyOf>::detach(const Key& key, ObserverType* newOb)
+{
+    typename BucketMap::iterator iter = mBuckets.find(key);
+
+    assert(iter != mBuckets.end());
+
+    if (iter != mBuckets.end())
+    {
+        iter->second.detach(newOb);
+    }
+}
+
+template<class T, class Key, class KeyOf>
+void tKeyedSubject<T, Key, KeyOf>::detachAll()
+{
+    // Detached rather than erased, as one of the buckets may be in the middle of notifying
+    for(typename BucketMap::iterator iter = mBuckets.begin(); iter != mBuckets.end(); iter++)
+    {
+        iter->second.detachAll();
+    }
+}
+
+template<class T, class Key, class KeyOf>
+tConnection tKeyedSubject<T, Key, KeyOf>::connect(const Key& key, const tDelegate<T>& callback)
+{
+    return mBuckets[key].connect(callback);
+}
+
+template<class T, class Key, class KeyOf>
+void tKeyedSubject<T, Key, KeyOf>::disconnect(const Key& key, tConnection& connection)
+{
+    typename BucketMap::iterator iter = mBuckets.find(key);
+
+    assert(iter != mBuckets.end());
+
+    if (iter != mBuckets.end())
+    {
+        iter->second.disconnect(connection);
+    }
+}
+
+template<class T, class Key, class KeyOf>
+void tKeyedSubject<T, Key, KeyOf>::notify(ParamType msg)
+{
+    typename BucketMap::iterator iter = mBuckets.find(mKeyOf(msg));
+
+    if (iter != mBuckets.end())
+    {
+        iter->second.notify(msg);
+    }
+}
+
+template<class T, class Key, class KeyOf>
+bool tKeyedSubject<T, Key, KeyOf>::isAttached(const Key& key, const ObserverType* ob) const
+{
+    typename BucketMap::const_iterator iter = mBuckets.find(key);
+
+    return iter != mBuckets.end() && iter->second.isAttached(ob);
+}
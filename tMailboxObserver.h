@@ -0,0 +1,223 @@
+/*
+ Observer Template (C++) by TJ Grant (tjgrant@tatewake.com)
+
+ tMailboxObserver: an observer whose update() runs on the thread that owns it.
+
+ //--
+
+ Copyright (c) 2011-02-01 TJ Grant (tjgrant@tatewake.com)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#pragma once
+
+#include "tObserver.h"
+
+#if __cplusplus >= 201103L
+#include <atomic>
+#endif
+
+#if __cplusplus >= 201103L
+// An observer whose update() runs on the thread that owns it, whenever that thread calls drain(), rather than on
+// whichever thread notified. Subjects hand messages to a wait-free single-producer/single-consumer ring instead of
+// calling update(); a full ring drops the message and counts it in dropped(). Each subject gets a ring of its own, kept
+// in its link and found through it, so subjects may notify from different threads at once; each subject must still
+// notify from one thread at a time. Rings are made as subjects attach and freed as they detach, along with anything
+// still undelivered in them; so attach, detach and destruction happen on the owner's thread, and never while any of
+// its subjects is notifying. Messages from one subject come out of drain() in order; those from different subjects
+// are not interleaved in any particular way.
+template<class T>
+class tMailboxObserver
+: public tObserver<T>
+{
+private:
+    typedef tObserver<T>                        BaseType;
+    typedef typename tMessageParam<T>::Type     ParamType;
+    typedef typename tMessageValue<T>::Type     ValueType;
+
+    struct Slot
+    {
+        alignas(ValueType) unsigned char mStorage[sizeof(ValueType)];
+    };
+
+    // The ring for one subject, held in its link's mState
+    struct Edge
+    {
+        Slot*                   mSlots;
+        std::atomic<size_t>     mHead;      // written by the owner only
+        char                    mPad[64];   // keeps the two ends off one cache line
+        std::atomic<size_t>     mTail;      // written by the subject's notifying thread only
+    };
+
+private:
+    size_t                          mMask;
+    std::atomic<size_t>             mDropped;
+    Edge*                           mDrainingEdge;          // the ring drain() is calling update() from
+    bool                            mDrainingEdgeDetached;  // its subject detached meanwhile; drain() frees it
+
+private:
+    static void Enqueue(BaseType* ob, size_t link, ParamType msg);
+
+    void DestroyEdge(Edge* edge);
+
+    virtual void* CreateLinkState();
+    virtual void DestroyLinkState(void* state);
+
+public:
+    explicit tMailboxObserver(size_t capacity = 256);
+    tMailboxObserver(const tMailboxObserver& other) = delete;
+    virtual ~tMailboxObserver();
+
+public:
+    tMailboxObserver& operator=(const tMailboxObserver& other) = delete;
+
+public:
+    size_t drain(size_t maxMessages = size_t(-1));
+    size_t dropped() const      { return mDropped.load(std::memory_order_relaxed); }
+};
+#endif
+
+#if __cplusplus >= 201103L
+template<class T>
+void tMailboxObserver<T>::Enqueue(BaseType* ob, size_t link, ParamType msg)
+{
+    tMailboxObserver* mailbox = static_cast<tMailboxObserver*>(ob);
+    Edge* edge = static_cast<Edge*>(ob->mSubjects[link].mState);
+
+    size_t tail = edge->mTail.load(std::memory_order_relaxed);
+
+    if (tail - edge->mHead.load(std::memory_order_acquire) > mailbox->mMask)
+    {
+        mailbox->mDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    new (edge->mSlots[tail & mailbox->mMask].mStorage) ValueType(msg);
+    edge->mTail.store(tail + 1, std::memory_order_release);
+}
+
+template<class T>
+void tMailboxObserver<T>::DestroyEdge(Edge* edge)
+{
+    // Whatever's left is destroyed undelivered
+    for(size_t head = edge->mHead.load(); head != edge->mTail.load(); head++)
+    {
+        reinterpret_cast<ValueType*>(edge->mSlots[head & mMask].mStorage)->~ValueType();
+    }
+
+    delete[] edge->mSlots;
+    delete edge;
+}
+
+template<class T>
+void* tMailboxObserver<T>::CreateLinkState()
+{
+    Edge* edge = new Edge;
+
+    edge->mSlots = new Slot[mMask + 1];
+    edge->mHead.store(0, std::memory_order_relaxed);
+    edge->mTail.store(0, std::memory_order_relaxed);
+
+    return edge;
+}
+
+template<class T>
+void tMailboxObserver<T>::DestroyLinkState(void* state)
+{
+    Edge* edge = static_cast<Edge*>(state);
+
+    // Detached from within update(); drain() is still using the ring, and the message in it
+    if (edge == mDrainingEdge)
+    {
+        mDrainingEdgeDetached = true;
+        return;
+    }
+
+    DestroyEdge(edge);
+}
+
+template<class T>
+tMailboxObserver<T>::tMailboxObserver(size_t capacity)
+:   mMask(0),
+mDropped(0),
+mDrainingEdge(NULL),
+mDrainingEdgeDetached(false)
+{
+    size_t size = 2;
+
+    while (size < capacity)
+    {
+        size *= 2;
+    }
+
+    mMask = size - 1;
+
+    this->UseUpdateFunction(&Enqueue);
+}
+
+template<class T>
+tMailboxObserver<T>::~tMailboxObserver()
+{
+    // Here rather than in ~tObserver, which would no longer reach DestroyLinkState
+    this->InformallyDetachAllSubjects();
+}
+
+template<class T>
+size_t tMailboxObserver<T>::drain(size_t maxMessages)
+{
+    size_t count = 0;
+
+    // update() may attach or detach subjects; a detach swaps the last link into the gap, so the index only moves on
+    // past a ring that's still in place
+    for(size_t i = 0; i < this->mSubjects.size() && count < maxMessages; )
+    {
+        Edge* edge = static_cast<Edge*>(this->mSubjects[i].mState);
+        size_t head = edge->mHead.load(std::memory_order_relaxed);
+        size_t tail = edge->mTail.load(std::memory_order_acquire);
+
+        mDrainingEdge = edge;
+
+        while (head != tail && count < maxMessages && !mDrainingEdgeDetached)
+        {
+            ValueType* msg = reinterpret_cast<ValueType*>(edge->mSlots[head & mMask].mStorage);
+
+            this->update(*msg);
+
+            msg->~ValueType();
+
+            // Handed back one at a time so the producer gets the room as soon as possible
+            edge->mHead.store(++head, std::memory_order_release);
+            count++;
+        }
+
+        mDrainingEdge = NULL;
+
+        if (mDrainingEdgeDetached)
+        {
+            mDrainingEdgeDetached = false;
+            DestroyEdge(edge);
+        }
+        else if (i < this->mSubjects.size() && this->mSubjects[i].mState == edge)
+        {
+            i++;
+        }
+    }
+
+    return count;
+}
+#endif
@@ -27,212 +27,2053 @@
 
 #pragma once
 
-#include <list>
+#include <new>
+#include <vector>
+#include <cstddef>
+#include <iterator>
 #include <algorithm>
 #include <cassert>
 
-template<class T> class tSubject;
+#if __cplusplus >= 201103L
+#include <utility>
+#include <type_traits>
+#endif
+
+#if __cplusplus >= 201703L
+#include <tuple>
+#endif
+
+template<class T, size_t N = 0> class tSubject;
+template<class T> class tParallelSubject;
 template<class T> class tObserver;
+template<class Derived, class T> class tStaticObserver;
+template<class T> class tMailboxObserver;
+
+// The type a message of type T can be stored as once notify() has returned (const Event& -> Event)
+template<class T> struct tMessageValue                  { typedef T Type; };
+template<class T> struct tMessageValue<const T>         { typedef T Type; };
+template<class T> struct tMessageValue<T&>              { typedef T Type; };
+template<class T> struct tMessageValue<const T&>        { typedef T Type; };
+
+// How a message of type T is handed around inside a subject; never by value, so it's only copied where update() asks
+template<class T> struct tMessageParam                  { typedef const T& Type; };
+template<class T> struct tMessageParam<T&>              { typedef T& Type; };
+
+// How a run of messages of type T is handed to notifyBatch() and updateBatch()
+template<class T> struct tMessageBatch                  { typedef const typename tMessageValue<T>::Type* Type; };
+template<class T> struct tMessageBatch<T&>              { typedef T* Type; };
+
+// Where link storage comes from. Subjects and observers use tLinkPool unless given one of these with setAllocator();
+// the allocator must outlive everything it was given to. allocate() may round bytes up and report the real size back.
+class tLinkAllocator
+{
+public:
+    virtual ~tLinkAllocator() { }
+
+public:
+    virtual void* allocate(size_t& bytes) = 0;
+    virtual void deallocate(void* ptr, size_t bytes) = 0;
+};
+
+// Bundled allocator handing out blocks of one fixed size from chunks it owns; requests larger than a block go to the heap.
+// Not thread-safe: share one between subjects/observers only where notify and update are already serialized.
+class tFixedSizePool
+: public tLinkAllocator
+{
+private:
+    struct FreeBlock
+    {
+        FreeBlock*  mNext;
+    };
+
+    struct Chunk
+    {
+        Chunk*      mNext;
+    };
+
+private:
+    size_t      mBlockSize;
+    size_t      mBlocksPerChunk;
+    FreeBlock*  mFreeBlocks;
+    Chunk*      mChunks;
+
+private:
+    void AddChunk();
+
+private:
+    tFixedSizePool(const tFixedSizePool& other);
+    tFixedSizePool& operator=(const tFixedSizePool& other);
+
+public:
+    tFixedSizePool(size_t blockSize = 256, size_t blocksPerChunk = 64);
+    virtual ~tFixedSizePool();
+
+public:
+    virtual void* allocate(size_t& bytes);
+    virtual void deallocate(void* ptr, size_t bytes);
+};
+
+// Default storage for link arrays: size-classed free lists, so attach/detach churn recycles blocks instead of hitting the heap.
+// Pools are per-thread (C++11 and later), which keeps them lock-free and leaves thread safety where it always was.
+class tLinkPool
+{
+private:
+    enum
+    {
+        kMinShift   = 5,                    // 32 byte blocks
+        kClassCount = 16                    // ...up to 1MB; larger blocks go straight to the heap
+    };
+
+    struct FreeBlock
+    {
+        FreeBlock*  mNext;
+    };
+
+    struct Lists
+    {
+        FreeBlock*  mHeads[kClassCount];
+        bool        mClosed;
+    };
+
+    struct Reaper
+    {
+        ~Reaper();
+    };
+
+private:
+    static Lists* GetLists();
+    static size_t ClassOf(size_t bytes);
+
+public:
+    static void* Allocate(size_t& bytes);
+    static void Deallocate(void* ptr, size_t bytes);
+    static void Trim();
+};
+
+// Minimal contiguous array of trivially copyable links, allocated from tLinkPool or a tLinkAllocator.
+// Capacity is kept across clear() so steady-state attach/detach does no allocation at all.
+template<class L>
+class tLinkArray
+{
+private:
+    L*                  mData;
+    size_t              mSize;
+    size_t              mCapacity;
+    L*                  mInlineBuffer;
+    size_t              mInlineCapacity;
+    tLinkAllocator*     mAllocator;
+
+private:
+    void Grow(size_t minCapacity);
+    void Release();
+    L* AllocateBlock(size_t& capacity) const;
+    void DeallocateBlock(L* block, size_t capacity) const;
+
+public:
+    typedef L*          iterator;
+    typedef const L*    const_iterator;
+
+public:
+    tLinkArray();
+    tLinkArray(const tLinkArray& other);
+    ~tLinkArray();
+
+public:
+    tLinkArray& operator=(const tLinkArray& other);
+
+public:
+    size_t size() const                     { return mSize; }
+    bool empty() const                      { return mSize == 0; }
+    L& operator[](size_t index)             { return mData[index]; }
+    const L& operator[](size_t index) const { return mData[index]; }
+    L& back()                               { return mData[mSize - 1]; }
+    iterator begin()                        { return mData; }
+    iterator end()                          { return mData + mSize; }
+    const_iterator begin() const            { return mData; }
+    const_iterator end() const              { return mData + mSize; }
+
+    void push_back(const L& link);
+    void pop_back();
+    void truncate(size_t newSize);
+    void clear();
+    void reserve(size_t newCapacity);
+    void useInlineBuffer(L* buffer, size_t capacity);
+    void setAllocator(tLinkAllocator* allocator);
+    void takeFrom(tLinkArray& other);
+};
+
+// Handed back by tSubject::connect() and given to disconnect() to undo it; default constructed, it's connected to nothing.
+// Only meaningful to the subject that issued it.
+class tConnection
+{
+private:
+    size_t  mId;
+
+public:
+    tConnection() : mId(0) { }
+
+public:
+    bool connected() const  { return mId != 0; }
+
+    template<class T, size_t N> friend class tSubject;
+};
+
+// Scopes a pass that may delete the object it's running on: slot points at deleted() while the guard is alive, and the
+// object's destructor sets *slot. Guards nest; one that sees the deletion passes it on to the guard it displaced, and
+// otherwise puts that guard back in the slot.
+class tDeletionGuard
+{
+private:
+    bool*&  mSlot;
+    bool*   mOuter;
+    bool    mDeleted;
+
+private:
+    tDeletionGuard(const tDeletionGuard& other);
+    tDeletionGuard& operator=(const tDeletionGuard& other);
+
+public:
+    explicit tDeletionGuard(bool*& slot);
+    ~tDeletionGuard();
 
+public:
+    const bool& deleted() const     { return mDeleted; }
+};
+
+// A callable for tSubject::connect() that never allocates: a thunk, plus the callable itself copied into kCapacity
+// bytes of inline storage. Free functions, object/member function pairs and lambdas with a few captures all fit;
+// anything larger is rejected at compile time, as is (C++11 and later) anything that isn't trivially copyable.
 template<class T>
-class tSubject
+class tDelegate
 {
+public:
+    enum { kCapacity = 3 * sizeof(void*) };
+
+private:
+    typedef typename tMessageParam<T>::Type ParamType;
+    typedef void (*Invoker)(void* callable, ParamType msg);
+
+    union Storage
+    {
+        void*       mPointer;
+        void        (*mFunction)();
+        long double mLongDouble;
+        char        mBytes[kCapacity];
+    };
+
+    template<class C>
+    struct MethodCall
+    {
+        C*      mObject;
+        void    (C::*mMethod)(T);
+
+        void operator()(ParamType msg) const    { (mObject->*mMethod)(msg); }
+    };
+
 private:
+    Invoker     mInvoke;
+    Storage     mStorage;
+
+private:
+    template<class F> static void Invoke(void* callable, ParamType msg);
+    template<class F> void Store(const F& callable);
+
+public:
+    tDelegate();
+    tDelegate(void (*function)(T));
+    template<class F> tDelegate(const F& callable);
+    template<class C> tDelegate(C* object, void (C::*method)(T));
+
+public:
+    bool empty() const                  { return !mInvoke; }
+    void operator()(ParamType msg)      { mInvoke(&mStorage, msg); }
+};
+
+// tSubject<T> holds its observers in pooled storage; tSubject<T, N> (below) keeps the first N of them inline
+template<class T>
+class tSubject<T, 0>
+{
+protected:
     typedef tObserver<T>                ObserverType;
-    typedef std::list<ObserverType*>    ListType;
+
+    // One side of a subject/observer edge; mBackIndex is where the other side lives in the observer's mSubjects.
+    // mUpdate, when set, is called instead of the virtual update() (see tStaticObserver).
+    struct ObserverLink
+    {
+        ObserverType*                           mObserver;
+        size_t                                  mBackIndex;
+        typename ObserverType::UpdateFunction   mUpdate;
+    };
+
+    typedef tLinkArray<ObserverLink>    ListType;
+
+    typedef typename tMessageParam<T>::Type ParamType;
+
+    // A connect()ed callable; mIds only ever increase along the list, and an empty mCallback marks a disconnected slot
+    struct CallbackLink
+    {
+        tDelegate<T>    mCallback;
+        size_t          mId;
+    };
+
+    typedef tLinkArray<CallbackLink>    CallbackListType;
 
 private:
-    ListType    mObservers;
-    ListType    mNewObservers;
-    bool        mCurrentlyNotifying;
-    bool*       mSubjectDeletedPtr;
+    // FIFO for notifications made from within update(); see setQueueNestedNotify. Type-erased so that message
+    // types which can't be stored by value (abstract, non-copyable) only fail to compile if queueing is used.
+    class NestedQueue
+    {
+    public:
+        virtual ~NestedQueue() { }
+
+    public:
+        virtual void push(ParamType msg) = 0;
+        virtual bool dispatchNext(tSubject& subject, const bool& subjectDeleted) = 0;
+        virtual void clear() = 0;
+    };
+
+    template<class V>
+    class NestedQueueImpl
+    : public NestedQueue
+    {
+    private:
+        std::vector<V>  mMessages;          // reused between notifies; only grows, never shrinks
+        size_t          mHead;
+
+    public:
+        NestedQueueImpl() : mHead(0) { }
+
+    public:
+        virtual void push(ParamType msg)
+        {
+            mMessages.push_back(msg);
+        }
+
+        virtual bool dispatchNext(tSubject& subject, const bool& subjectDeleted)
+        {
+            if (mHead == mMessages.size())
+            {
+                clear();
+                return false;
+            }
+
+            // Copied out first: the dispatch may queue more and reallocate, or delete the subject (and this with it)
+            V msg(mMessages[mHead++]);
+            subject.Dispatch(msg, subjectDeleted);
+            return true;
+        }
+
+        virtual void clear()
+        {
+            mMessages.clear();
+            mHead = 0;
+        }
+    };
+
+protected:
+    bool*           mSubjectDeletedPtr;     // the innermost tDeletionGuard's flag while a pass is running
+
+private:
+    ListType        mObservers;
+    size_t          mNullCount;
+    size_t          mNotifyCount;
+    bool            mCurrentlyNotifying;
+    NestedQueue*    mNestedQueue;
+
+    CallbackListType    mCallbacks;
+    size_t              mNullCallbackCount;
+    size_t              mCallbackNotifyCount;
+    size_t              mLastConnectionId;
 
 private:
-    void InformallyAttachObserver(ObserverType* newOb);
-    void InformallyDetachObserver(ObserverType* newOb);
+    void InformallyAttachObserver(ObserverType* newOb, size_t backIndex);
+    void InformallyDetachObserver(size_t index);
+    void ClearObserverSlot(size_t index);
+    void RemoveNullObserversIfSparse();
+    void RemoveNullObservers();
+    size_t FindObserver(const ObserverType* ob) const;
     void FormallyAttachIfNotNull(const ListType& observers);
-    void FormallyAttach(const ListType& observers);
+    void CopyCallbacks(const CallbackListType& callbacks);
+    size_t FindCallback(const tConnection& connection) const;
+    void RemoveNullCallbacks();
+    void TakeObservers(tSubject& other);
+    void Deliver(size_t index, ParamType msg);
+    void FinishNotify(const bool& subjectDeleted);
+
+protected:
+    void UseInlineStorage(ObserverLink* buffer, size_t capacity);
+    void InformallyDetachAllObservers();
+
+    // One full pass of a message, or of a run of them, over the observers and then the callables. Every notification
+    // ends up here, queued ones included, so a derived subject that overrides these sees them all, in order, from
+    // within the pass. An override must return as soon as subjectDeleted is set.
+    virtual void Dispatch(ParamType msg, const bool& subjectDeleted);
+    virtual void DispatchBatch(typename tMessageBatch<T>::Type msgs, size_t count, const bool& subjectDeleted);
+
+public:
+    tSubject();
+    tSubject(const tSubject& other);
+#if __cplusplus >= 201103L
+    tSubject(tSubject&& other) noexcept;
+#endif
+    virtual ~tSubject();
+
+public:
+    tSubject& operator=(const tSubject& other);
+#if __cplusplus >= 201103L
+    tSubject& operator=(tSubject&& other) noexcept;
+#endif
+
+public:
+    void attach(ObserverType* newOb);
+    void detach(ObserverType* newOb);
+    void detachAll();
+
+    // Bulk forms taking a forward-iterator range of observer pointers
+    template<class Iter> void attach(Iter first, Iter last);
+    template<class Iter> void detach(Iter first, Iter last);
+
+    void notify(ParamType msg);
+#if __cplusplus >= 201103L
+    template<class... Args> void emplaceNotify(Args&&... args);
+#endif
+
+    // Delivers count messages observer by observer, rather than message by message. Observers that called AcceptBatches()
+    // get the whole run in one updateBatch() call; the rest get update() for each, stopping as soon as they're detached or
+    // deleted.
+    void notifyBatch(typename tMessageBatch<T>::Type msgs, size_t count);
+
+    // Callables attached without an observer object; each message reaches them after the observers, in connect order.
+    // detachAll() drops them too. A copy of a subject copies its callables, but not the tokens for them.
+    tConnection connect(const tDelegate<T>& callback);
+    template<class C> tConnection connect(C* object, void (C::*method)(T));
+    void disconnect(tConnection& connection);
+
+    bool isAttached(const ObserverType* ob) const;
+    void setAllocator(tLinkAllocator* allocator);
+    void setQueueNestedNotify(bool queue);
+
+    friend class tObserver<T>;
+#if __cplusplus >= 201103L
+    template<class U> friend class tParallelSubject;
+#endif
+};
+
+// A subject with room for N observers inside the object itself; only the N+1th attach touches tLinkPool
+template<class T, size_t N>
+class tSubject
+: public tSubject<T>
+{
+private:
+    typedef tSubject<T>                     BaseType;
+    typedef typename BaseType::ObserverLink LinkType;
+
+private:
+    LinkType    mInlineObservers[N];
 
 public:
     tSubject();
     tSubject(const tSubject& other);
 #if __cplusplus >= 201103L
-    tSubject(tSubject&& other);
+    tSubject(tSubject&& other) noexcept;
 #endif
     virtual ~tSubject();
 
-public:
-    tSubject& operator=(const tSubject& other);
+public:
+    tSubject& operator=(const tSubject& other);
+#if __cplusplus >= 201103L
+    tSubject& operator=(tSubject&& other) noexcept;
+#endif
+};
+
+template<class T>
+class tObserver
+{
+private:
+    typedef tSubject<T>             SubjectType;
+    // Called in place of update() when set; link is the index in mSubjects of the subject delivering
+    typedef void (*UpdateFunction)(tObserver* ob, size_t link, typename tMessageParam<T>::Type msg);
+
+    // One side of a subject/observer edge; mBackIndex is where the other side lives in the subject's mObservers.
+    // mState is whatever CreateLinkState() made for the edge.
+    struct SubjectLink
+    {
+        SubjectType*    mSubject;
+        size_t          mBackIndex;
+        void*           mState;
+    };
+
+    typedef tLinkArray<SubjectLink> ListType;
+
+private:
+    ListType        mSubjects;
+    UpdateFunction  mUpdateFunction;
+    bool            mAcceptsBatches;
+
+private:
+    size_t InformallyAttachSubject(SubjectType* newSub, size_t backIndex);
+    void InformallyDetachSubject(size_t index);
+    void InformallyDetachAllSubjects();
+    size_t FindSubject(const SubjectType* sub) const;
+    void FormallyAttachAllSubjects(const ListType& newSub);
+    void TakeSubjects(tObserver& other);
+    void UseUpdateFunction(UpdateFunction update);
+
+    // Per-edge state for a derived observer: made as each subject attaches, and handed back as it detaches. Not called
+    // on a derived observer while it's being constructed or destroyed, nor carried over by copies; one that keeps state
+    // here detaches all its subjects in its own destructor, and can't be copied or moved.
+    virtual void* CreateLinkState();
+    virtual void DestroyLinkState(void* state);
+
+protected:
+    // Call from the constructor of an observer whose updateBatch() should be handed notifyBatch() runs whole
+    void AcceptBatches(bool accept = true);
+
+public:
+    tObserver();
+    tObserver(const tObserver& other);
+#if __cplusplus >= 201103L
+    tObserver(tObserver&& other) noexcept;
+#endif
+    virtual ~tObserver();
+
+public:
+    tObserver& operator=(const tObserver& other);
+#if __cplusplus >= 201103L
+    tObserver& operator=(tObserver&& other) noexcept;
+#endif
+
+public:
+    void setAllocator(tLinkAllocator* allocator);
+
+public:
+    virtual void update(T msg) = 0;
+
+    // Called by tSubject::notifyBatch() for observers that called AcceptBatches(); by default, update() for each in turn
+    virtual void updateBatch(typename tMessageBatch<T>::Type msgs, size_t count);
+
+    friend class tSubject<T>;
+    template<class Derived, class U> friend class tStaticObserver;
+#if __cplusplus >= 201103L
+    template<class U> friend class tMailboxObserver;
+#endif
+};
+
+// A subject that delivers by priority rather than attachment order: higher priorities first, and attachment order
+// among equal ones. Each priority in use is a tSubject<T> bucket in a contiguous array kept sorted, so attach is a
+// binary search and notify is a linear scan over the buckets and, within each, its links.
+// An observer attached during notify at a priority the pass hasn't reached yet is included in that pass.
+template<class T>
+class tPrioritySubject
+{
+private:
+    typedef tSubject<T>                         SubjectType;
+    typedef tObserver<T>                        ObserverType;
+    typedef typename tMessageParam<T>::Type     ParamType;
+
+    struct Bucket
+    {
+        int             mPriority;
+        SubjectType*    mSubject;
+    };
+
+    typedef std::vector<Bucket>     BucketList;
+
+private:
+    BucketList  mBuckets;                   // highest priority first; buckets stay until the subject goes
+    bool        mCurrentlyNotifying;
+    bool*       mSubjectDeletedPtr;
+
+private:
+    size_t FindBucket(int priority) const;
+    SubjectType* FindOrAddBucket(int priority);
+    SubjectType* FindObserverBucket(const ObserverType* ob) const;
+
+private:
+    tPrioritySubject(const tPrioritySubject& other);
+    tPrioritySubject& operator=(const tPrioritySubject& other);
+
+public:
+    tPrioritySubject();
+    virtual ~tPrioritySubject();
+
+public:
+    void attach(ObserverType* newOb, int priority = 0);
+    void detach(ObserverType* newOb);
+    void detachAll();
+
+    tConnection connect(const tDelegate<T>& callback, int priority = 0);
+    void disconnect(tConnection& connection, int priority = 0);
+
+    void notify(ParamType msg);
+
+    bool isAttached(const ObserverType* ob) const;
+};
+
+#if __cplusplus >= 201703L
+// A subject whose core observers are fixed at compile time. They're held by reference and called one after another
+// through a fold expression, with no links, no bookkeeping and nothing virtual, so each update can be inlined.
+// It's still a tSubject<T>; observers attached dynamically are notified after the static ones, in the same pass, so a
+// notify through a tSubject<T>& reaches the static observers too, and one made from within update() is nested as usual.
+// A static observer may delete the subject, but must itself outlive it.
+template<class T, class... Observers>
+class tStaticSubject
+: public tSubject<T>
+{
+private:
+    typedef tSubject<T>                         BaseType;
+    typedef typename tMessageParam<T>::Type     ParamType;
+
+private:
+    std::tuple<Observers&...>   mStaticObservers;
+
+private:
+    template<class Observer> static bool UpdateEach(Observer& ob, typename tMessageBatch<T>::Type msgs, size_t count, const bool& subjectDeleted);
+
+protected:
+    virtual void Dispatch(ParamType msg, const bool& subjectDeleted);
+
+    // Each static observer takes the whole run in turn, then the attached ones get it as tSubject gives it them
+    virtual void DispatchBatch(typename tMessageBatch<T>::Type msgs, size_t count, const bool& subjectDeleted);
+
+public:
+    explicit tStaticSubject(Observers&... observers);
+    tStaticSubject(const tStaticSubject& other) = default;
+
+public:
+    // The static observers can't be rebound, so there's nothing sensible for assignment to do
+    tStaticSubject& operator=(const tStaticSubject& other) = delete;
+};
+#endif
+
+// CRTP base for observers whose subjects should call Derived::update directly, as a plain function pointer
+// stored next to the observer in each subject, rather than loading it out of the vtable on every notify.
+// Derived still just implements update(T msg); it is also reachable virtually as usual. Subjects call Derived::update
+// by name, so an override further down would be skipped: Derived must be final (checked from C++14 on).
+template<class Derived, class T>
+class tStaticObserver
+: public tObserver<T>
+{
+private:
+    typedef tObserver<T>    BaseType;
+
+private:
+    static void DirectUpdate(BaseType* ob, size_t, typename tMessageParam<T>::Type msg);
+
+public:
+    tStaticObserver();
+    tStaticObserver(const tStaticObserver& other);
+#if __cplusplus >= 201103L
+    tStaticObserver(tStaticObserver&& other) noexcept;
+#endif
+
+public:
+    tStaticObserver& operator=(const tStaticObserver& other);
+#if __cplusplus >= 201103L
+    tStaticObserver& operator=(tStaticObserver&& other) noexcept;
+#endif
+};
+
+#if __cplusplus >= 201103L
+inline tLinkPool::Reaper::~Reaper()
+{
+    Trim();
+    GetLists()->mClosed = true;
+}
+
+inline tLinkPool::Lists* tLinkPool::GetLists()
+{
+    // Lists is trivially destructible, so it stays usable for links freed after this thread's Reaper has run
+    static thread_local Lists lists;
+    static thread_local Reaper reaper;
+
+    (void)reaper;
+    return &lists;
+}
+#else
+inline tLinkPool::Lists* tLinkPool::GetLists()
+{
+    // No portable thread-local storage; fall back to the heap rather than share one pool across threads
+    return NULL;
+}
+
+inline tLinkPool::Reaper::~Reaper()
+{
+}
+#endif
+
+inline size_t tLinkPool::ClassOf(size_t bytes)
+{
+    size_t index = 0;
+
+    while (index < kClassCount && (size_t(1) << (index + kMinShift)) < bytes)
+    {
+        index++;
+    }
+
+    return index;
+}
+
+inline void* tLinkPool::Allocate(size_t& bytes)
+{
+    size_t index = ClassOf(bytes);
+
+    if (index < kClassCount)
+    {
+        Lists* lists = GetLists();
+
+        bytes = size_t(1) << (index + kMinShift);
+
+        if (lists && lists->mHeads[index])
+        {
+            FreeBlock* block = lists->mHeads[index];
+            lists->mHeads[index] = block->mNext;
+            return block;
+        }
+    }
+
+    return ::operator new(bytes);
+}
+
+inline void tLinkPool::Deallocate(void* ptr, size_t bytes)
+{
+    size_t index = ClassOf(bytes);
+    Lists* lists = GetLists();
+
+    if (ptr && index < kClassCount && lists && !lists->mClosed)
+    {
+        FreeBlock* block = static_cast<FreeBlock*>(ptr);
+        block->mNext = lists->mHeads[index];
+        lists->mHeads[index] = block;
+    }
+    else
+    {
+        ::operator delete(ptr);
+    }
+}
+
+inline void tLinkPool::Trim()
+{
+    Lists* lists = GetLists();
+
+    if (lists)
+    {
+        for(size_t i = 0; i < kClassCount; i++)
+        {
+            while (lists->mHeads[i])
+            {
+                FreeBlock* block = lists->mHeads[i];
+                lists->mHeads[i] = block->mNext;
+                ::operator delete(block);
+            }
+        }
+    }
+}
+
+inline tFixedSizePool::tFixedSizePool(size_t blockSize, size_t blocksPerChunk)
+:   mBlockSize(blockSize < sizeof(FreeBlock) ? sizeof(FreeBlock) : blockSize),
+mBlocksPerChunk(blocksPerChunk ? blocksPerChunk : 1),
+mFreeBlocks(NULL),
+mChunks(NULL)
+{
+    // Keep every block pointer-aligned
+    mBlockSize = (mBlockSize + sizeof(void*) - 1) / sizeof(void*) * sizeof(void*);
+}
+
+inline tFixedSizePool::~tFixedSizePool()
+{
+    while (mChunks)
+    {
+        Chunk* chunk = mChunks;
+        mChunks = chunk->mNext;
+        ::operator delete(chunk);
+    }
+}
+
+inline void tFixedSizePool::AddChunk()
+{
+    // The chunk header is padded to a whole block so the blocks after it stay aligned
+    size_t headerSize = (sizeof(Chunk) + mBlockSize - 1) / mBlockSize * mBlockSize;
+    char* memory = static_cast<char*>(::operator new(headerSize + mBlockSize * mBlocksPerChunk));
+    Chunk* chunk = reinterpret_cast<Chunk*>(memory);
+
+    chunk->mNext = mChunks;
+    mChunks = chunk;
+
+    for(size_t i = 0; i < mBlocksPerChunk; i++)
+    {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(memory + headerSize + i * mBlockSize);
+        block->mNext = mFreeBlocks;
+        mFreeBlocks = block;
+    }
+}
+
+inline void* tFixedSizePool::allocate(size_t& bytes)
+{
+    if (bytes > mBlockSize)
+    {
+        return ::operator new(bytes);
+    }
+
+    if (!mFreeBlocks)
+    {
+        AddChunk();
+    }
+
+    FreeBlock* block = mFreeBlocks;
+    mFreeBlocks = block->mNext;
+    bytes = mBlockSize;
+
+    return block;
+}
+
+inline void tFixedSizePool::deallocate(void* ptr, size_t bytes)
+{
+    if (bytes > mBlockSize)
+    {
+        ::operator delete(ptr);
+    }
+    else if (ptr)
+    {
+        FreeBlock* block = static_cast<FreeBlock*>(ptr);
+        block->mNext = mFreeBlocks;
+        mFreeBlocks = block;
+    }
+}
+
+template<class L>
+L* tLinkArray<L>::AllocateBlock(size_t& capacity) const
+{
+    size_t bytes = capacity * sizeof(L);
+    void* block = mAllocator ? mAllocator->allocate(bytes) : tLinkPool::Allocate(bytes);
+
+    capacity = bytes / sizeof(L);
+    return static_cast<L*>(block);
+}
+
+template<class L>
+void tLinkArray<L>::Grow(size_t minCapacity)
+{
+    size_t newCapacity = mCapacity ? mCapacity * 2 : 4;
+
+    if (newCapacity < minCapacity)
+    {
+        newCapacity = minCapacity;
+    }
+
+    L* newData = AllocateBlock(newCapacity);
+
+    for(size_t i = 0; i < mSize; i++)
+    {
+        newData[i] = mData[i];
+    }
+
+    Release();
+
+    mData = newData;
+    mCapacity = newCapacity;
+}
+
+template<class L>
+void tLinkArray<L>::DeallocateBlock(L* block, size_t capacity) const
+{
+    if (mAllocator)
+    {
+        mAllocator->deallocate(block, capacity * sizeof(L));
+    }
+    else
+    {
+        tLinkPool::Deallocate(block, capacity * sizeof(L));
+    }
+}
+
+template<class L>
+void tLinkArray<L>::Release()
+{
+    if (mData != mInlineBuffer)
+    {
+        DeallocateBlock(mData, mCapacity);
+    }
+
+    mData = mInlineBuffer;
+    mCapacity = mInlineCapacity;
+}
+
+template<class L>
+tLinkArray<L>::tLinkArray()
+:   mData(NULL),
+mSize(0),
+mCapacity(0),
+mInlineBuffer(NULL),
+mInlineCapacity(0),
+mAllocator(NULL)
+{
+}
+
+template<class L>
+tLinkArray<L>::tLinkArray(const tLinkArray& other)
+:   mData(NULL),
+mSize(0),
+mCapacity(0),
+mInlineBuffer(NULL),
+mInlineCapacity(0),
+mAllocator(NULL)
+{
+    *this = other;
+}
+
+template<class L>
+tLinkArray<L>::~tLinkArray()
+{
+    Release();
+}
+
+template<class L>
+tLinkArray<L>& tLinkArray<L>::operator=(const tLinkArray& other)
+{
+    if (this != &other)
+    {
+        clear();
+        reserve(other.mSize);
+
+        for(size_t i = 0; i < other.mSize; i++)
+        {
+            mData[i] = other.mData[i];
+        }
+
+        mSize = other.mSize;
+    }
+
+    return *this;
+}
+
+template<class L>
+void tLinkArray<L>::push_back(const L& link)
+{
+    if (mSize == mCapacity)
+    {
+        Grow(mSize + 1);
+    }
+
+    mData[mSize++] = link;
+}
+
+template<class L>
+void tLinkArray<L>::pop_back()
+{
+    assert(mSize);
+    mSize--;
+}
+
+template<class L>
+void tLinkArray<L>::truncate(size_t newSize)
+{
+    assert(newSize <= mSize);
+    mSize = newSize;
+}
+
+template<class L>
+void tLinkArray<L>::clear()
+{
+    mSize = 0;
+}
+
+template<class L>
+void tLinkArray<L>::reserve(size_t newCapacity)
+{
+    if (newCapacity > mCapacity)
+    {
+        Grow(newCapacity);
+    }
+}
+
+template<class L>
+void tLinkArray<L>::useInlineBuffer(L* buffer, size_t capacity)
+{
+    assert(!mData && !mSize);
+
+    mData = mInlineBuffer = buffer;
+    mCapacity = mInlineCapacity = capacity;
+}
+
+template<class L>
+void tLinkArray<L>::setAllocator(tLinkAllocator* allocator)
+{
+    if (allocator != mAllocator)
+    {
+        if (mData != mInlineBuffer)
+        {
+            // Move the links into a block from the new allocator, returning the old block to whoever gave it out
+            L* oldData = mData;
+            size_t oldCapacity = mCapacity;
+
+            mData = mInlineBuffer;
+            mCapacity = mInlineCapacity;
+
+            if (mSize > mCapacity)
+            {
+                tLinkAllocator* oldAllocator = mAllocator;
+
+                mAllocator = allocator;
+                mCapacity = mSize;
+                mData = AllocateBlock(mCapacity);
+                mAllocator = oldAllocator;
+            }
+
+            for(size_t i = 0; i < mSize; i++)
+            {
+                mData[i] = oldData[i];
+            }
+
+            DeallocateBlock(oldData, oldCapacity);
+        }
+
+        mAllocator = allocator;
+    }
+}
+
+template<class L>
+void tLinkArray<L>::takeFrom(tLinkArray& other)
+{
+    assert(mSize == 0 && this != &other);
+
+    if (other.mData == other.mInlineBuffer)
+    {
+        // Links in someone else's inline buffer can't be adopted; copy them (into our own inline buffer, if they fit)
+        reserve(other.mSize);
+
+        for(size_t i = 0; i < other.mSize; i++)
+        {
+            mData[i] = other.mData[i];
+        }
+    }
+    else
+    {
+        // Adopt the block, and with it the allocator that has to give it back
+        Release();
+
+        mData = other.mData;
+        mCapacity = other.mCapacity;
+        mAllocator = other.mAllocator;
+
+        other.mData = other.mInlineBuffer;
+        other.mCapacity = other.mInlineCapacity;
+    }
+
+    mSize = other.mSize;
+    other.mSize = 0;
+}
+
+inline tDeletionGuard::tDeletionGuard(bool*& slot)
+:   mSlot(slot),
+mOuter(slot),
+mDeleted(false)
+{
+    slot = &mDeleted;
+}
+
+inline tDeletionGuard::~tDeletionGuard()
+{
+    // The slot went with the object; the outer flag, if any, is still on the stack
+    if (mDeleted)
+    {
+        if (mOuter)
+        {
+            *mOuter = true;
+        }
+    }
+    else
+    {
+        mSlot = mOuter;
+    }
+}
+
+template<class T>
+template<class F>
+void tDelegate<T>::Invoke(void* callable, ParamType msg)
+{
+    (*static_cast<F*>(callable))(msg);
+}
+
+template<class T>
+template<class F>
+void tDelegate<T>::Store(const F& callable)
+{
+#if __cplusplus >= 201103L
+    static_assert(sizeof(F) <= sizeof(Storage), "callable too large for tDelegate");
+    static_assert(alignof(F) <= alignof(Storage), "callable too strictly aligned for tDelegate");
+    static_assert(std::is_trivially_copyable<F>::value, "tDelegate copies callables bytewise");
+#else
+    typedef char CallableTooLarge[(sizeof(F) <= sizeof(Storage)) ? 1 : -1];
+    (void)sizeof(CallableTooLarge);
+#endif
+
+    new (static_cast<void*>(&mStorage)) F(callable);
+    mInvoke = &Invoke<F>;
+}
+
+template<class T>
+tDelegate<T>::tDelegate()
+:   mInvoke(NULL)
+{
+}
+
+template<class T>
+tDelegate<T>::tDelegate(void (*function)(T))
+:   mInvoke(NULL)
+{
+    assert(function);
+
+    if (function)
+    {
+        Store(function);
+    }
+}
+
+template<class T>
+template<class F>
+tDelegate<T>::tDelegate(const F& callable)
+:   mInvoke(NULL)
+{
+    Store(callable);
+}
+
+template<class T>
+template<class C>
+tDelegate<T>::tDelegate(C* object, void (C::*method)(T))
+:   mInvoke(NULL)
+{
+    assert(object && method);
+
+    MethodCall<C> call = { object, method };
+    Store(call);
+}
+
+template<class T>
+void tSubject<T>::InformallyAttachObserver(ObserverType* newOb, size_t backIndex)
+{
+    ObserverLink link = { newOb, backIndex, newOb->mUpdateFunction };
+
+    // Observers attached during notify land past the end of the current pass and are not notified until the next one
+    mObservers.push_back(link);
+}
+
+template<class T>
+void tSubject<T>::InformallyDetachObserver(size_t index)
+{
+    ClearObserverSlot(index);
+    RemoveNullObserversIfSparse();
+}
+
+template<class T>
+void tSubject<T>::ClearObserverSlot(size_t index)
+{
+    assert(index < mObservers.size() && mObservers[index].mObserver);
+
+    mObservers[index].mObserver = NULL;
+    mNullCount++;
+}
+
+template<class T>
+void tSubject<T>::RemoveNullObserversIfSparse()
+{
+    // Outside of notify, slots are compacted lazily once half of them are NULL
+    if (!mCurrentlyNotifying && mNullCount * 2 > mObservers.size())
+    {
+        RemoveNullObservers();
+    }
+}
+
+template<class T>
+void tSubject<T>::RemoveNullObservers()
+{
+    size_t count = 0;
+
+    // Everything before the first NULL is already where it belongs
+    while (count < mObservers.size() && mObservers[count].mObserver)
+    {
+        count++;
+    }
+
+    for(size_t i = count; i < mObservers.size(); i++)
+    {
+        if (mObservers[i].mObserver)
+        {
+            if (count != i)
+            {
+                mObservers[count] = mObservers[i];
+                mObservers[count].mObserver->mSubjects[mObservers[count].mBackIndex].mBackIndex = count;
+            }
+
+            count++;
+        }
+    }
+
+    mObservers.truncate(count);
+    mNullCount = 0;
+}
+
+template<class T>
+size_t tSubject<T>::FindObserver(const ObserverType* ob) const
+{
+    // Either side of an edge leads to the other, so search whichever list is shorter;
+    // a subject with 100k observers that each watch one subject costs O(1) per lookup
+    if (ob->mSubjects.size() <= mObservers.size())
+    {
+        size_t backIndex = ob->FindSubject(this);
+
+        return (backIndex < ob->mSubjects.size()) ? ob->mSubjects[backIndex].mBackIndex : mObservers.size();
+    }
+
+    for(size_t i = 0; i < mObservers.size(); i++)
+    {
+        if (mObservers[i].mObserver == ob)
+        {
+            return i;
+        }
+    }
+
+    return mObservers.size();
+}
+
+template<class T>
+void tSubject<T>::FormallyAttachIfNotNull(const ListType& observers)
+{
+    for(typename ListType::const_iterator iter = observers.begin() ; iter != observers.end(); iter++)
+    {
+        if (iter->mObserver)
+        {
+            attach(iter->mObserver);
+        }
+    }
+}
+
+template<class T>
+void tSubject<T>::CopyCallbacks(const CallbackListType& callbacks)
+{
+    // Tokens belong to the subject that issued them, so the copies are given ids of our own
+    for(typename CallbackListType::const_iterator iter = callbacks.begin(); iter != callbacks.end(); iter++)
+    {
+        if (!iter->mCallback.empty())
+        {
+            CallbackLink link = { iter->mCallback, ++mLastConnectionId };
+            mCallbacks.push_back(link);
+        }
+    }
+}
+
+template<class T>
+size_t tSubject<T>::FindCallback(const tConnection& connection) const
+{
+    size_t first = 0;
+    size_t last = mCallbacks.size();
+
+    // Ids are handed out in increasing order and compaction keeps the order, so this is a binary search
+    while (first < last)
+    {
+        size_t middle = first + (last - first) / 2;
+
+        if (mCallbacks[middle].mId < connection.mId)
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+
+    if (first < mCallbacks.size() && mCallbacks[first].mId == connection.mId && !mCallbacks[first].mCallback.empty())
+    {
+        return first;
+    }
+
+    return mCallbacks.size();
+}
+
+template<class T>
+void tSubject<T>::RemoveNullCallbacks()
+{
+    size_t count = 0;
+
+    for(size_t i = 0; i < mCallbacks.size(); i++)
+    {
+        if (!mCallbacks[i].mCallback.empty())
+        {
+            if (count != i)
+            {
+                mCallbacks[count] = mCallbacks[i];
+            }
+
+            count++;
+        }
+    }
+
+    mCallbacks.truncate(count);
+    mNullCallbackCount = 0;
+}
+
+template<class T>
+void tSubject<T>::UseInlineStorage(ObserverLink* buffer, size_t capacity)
+{
+    mObservers.useInlineBuffer(buffer, capacity);
+}
+
+template<class T>
+void tSubject<T>::InformallyDetachAllObservers()
+{
+    // Each link already knows where its other half lives, so this is one pass with no searching or copying
+    for(typename ListType::iterator iter = mObservers.begin(); iter != mObservers.end(); iter++)
+    {
+        if (iter->mObserver)
+        {
+            iter->mObserver->InformallyDetachSubject(iter->mBackIndex);
+            iter->mObserver = NULL;
+        }
+    }
+
+    // A notify in progress is still indexing into mObservers; leave it the NULL slots and let notify compact them
+    if (!mCurrentlyNotifying)
+    {
+        mObservers.clear();
+        mNullCount = 0;
+
+        mCallbacks.clear();
+        mNullCallbackCount = 0;
+    }
+    else
+    {
+        mNullCount = mObservers.size();
+
+        for(typename CallbackListType::iterator iter = mCallbacks.begin(); iter != mCallbacks.end(); iter++)
+        {
+            iter->mCallback = tDelegate<T>();
+        }
+
+        mNullCallbackCount = mCallbacks.size();
+    }
+}
+
+template<class T>
+void tSubject<T>::TakeObservers(tSubject& other)
+{
+    mObservers.takeFrom(other.mObservers);
+    mNullCount = other.mNullCount;
+
+    mCallbacks.takeFrom(other.mCallbacks);
+    mNullCallbackCount = other.mNullCallbackCount;
+    mLastConnectionId = other.mLastConnectionId;
+
+    // Stops any notify pass still running on other from indexing past its now-empty lists
+    other.mNullCount = 0;
+    other.mNotifyCount = 0;
+    other.mNullCallbackCount = 0;
+    other.mCallbackNotifyCount = 0;
+
+    for(typename ListType::iterator iter = mObservers.begin(); iter != mObservers.end(); iter++)
+    {
+        if (iter->mObserver)
+        {
+            iter->mObserver->mSubjects[iter->mBackIndex].mSubject = this;
+        }
+    }
+}
+
+template<class T>
+tSubject<T>::tSubject()
+:   mSubjectDeletedPtr(NULL),
+mNullCount(0),
+mNotifyCount(0),
+mCurrentlyNotifying(false),
+mNestedQueue(NULL),
+mNullCallbackCount(0),
+mCallbackNotifyCount(0),
+mLastConnectionId(0)
+{
+}
+
+template<class T>
+tSubject<T>::tSubject(const tSubject& other)
+:   mSubjectDeletedPtr(NULL),
+mNullCount(0),
+mNotifyCount(0),
+mCurrentlyNotifying(false),
+mNestedQueue(NULL),
+mNullCallbackCount(0),
+mCallbackNotifyCount(0),
+mLastConnectionId(0)
+{
+    if (this != &other)
+    {
+        FormallyAttachIfNotNull(other.mObservers);
+        CopyCallbacks(other.mCallbacks);
+    }
+}
+
+#if __cplusplus >= 201103L
+template<class T>
+tSubject<T>::tSubject(tSubject&& other) noexcept
+:   mSubjectDeletedPtr(NULL),
+mNullCount(0),
+mNotifyCount(0),
+mCurrentlyNotifying(false),
+mNestedQueue(NULL),
+mNullCallbackCount(0),
+mCallbackNotifyCount(0),
+mLastConnectionId(0)
+{
+    if (this != &other)
+    {
+        TakeObservers(other);
+
+        // Queued messages belong to other's notify, which the move has cut short
+        std::swap(mNestedQueue, other.mNestedQueue);
+
+        if (mNestedQueue)
+        {
+            mNestedQueue->clear();
+        }
+    }
+}
+#endif
+
+template<class T>
+tSubject<T>::~tSubject()
+{
+    if (mSubjectDeletedPtr)
+    {
+        *mSubjectDeletedPtr = true;
+    }
+
+    InformallyDetachAllObservers();
+
+    delete mNestedQueue;
+}
+
+template<class T>
+tSubject<T>& tSubject<T>::operator=(const tSubject<T>& other)
+{
+    if (this != &other)
+    {
+        detachAll();
+
+        FormallyAttachIfNotNull(other.mObservers);
+        CopyCallbacks(other.mCallbacks);
+    }
+
+    return *this;
+}
+
+#if __cplusplus >= 201103L
+template<class T>
+tSubject<T>& tSubject<T>::operator=(tSubject&& other) noexcept
+{
+    if (this != &other)
+    {
+        detachAll();
+
+        // If we're mid-notify, the rest of that pass is over; none of the observers it was walking are ours any more
+        mObservers.clear();
+        mNullCount = 0;
+        mNotifyCount = 0;
+
+        mCallbacks.clear();
+        mNullCallbackCount = 0;
+        mCallbackNotifyCount = 0;
+
+        TakeObservers(other);
+
+        // As with the links, the queueing mode follows the move; any messages still queued on either side are dropped
+        std::swap(mNestedQueue, other.mNestedQueue);
+
+        if (mNestedQueue)
+        {
+            mNestedQueue->clear();
+        }
+
+        if (other.mNestedQueue)
+        {
+            other.mNestedQueue->clear();
+        }
+    }
+
+    return *this;
+}
+#endif
+
+template<class T>
+void tSubject<T>::attach(ObserverType* newOb)
+{
+    assert(newOb);
+    assert(!isAttached(newOb));
+
+    if (newOb)
+    {
+        size_t backIndex = newOb->InformallyAttachSubject(this, mObservers.size());
+        InformallyAttachObserver(newOb, backIndex);
+    }
+}
+
+template<class T>
+void tSubject<T>::detach(ObserverType* newOb)
+{
+    assert(newOb);
+    assert(isAttached(newOb));
+
+    if (newOb)
+    {
+        size_t index = FindObserver(newOb);
+
+        if (index < mObservers.size())
+        {
+            newOb->InformallyDetachSubject(mObservers[index].mBackIndex);
+            InformallyDetachObserver(index);
+        }
+    }
+}
+
+template<class T>
+template<class Iter>
+void tSubject<T>::attach(Iter first, Iter last)
+{
+    mObservers.reserve(mObservers.size() + std::distance(first, last));
+
+    for(; first != last; first++)
+    {
+        ObserverType* newOb = *first;
+
+        assert(newOb);
+        assert(!isAttached(newOb));
+
+        if (newOb)
+        {
+            size_t backIndex = newOb->InformallyAttachSubject(this, mObservers.size());
+            InformallyAttachObserver(newOb, backIndex);
+        }
+    }
+}
+
+template<class T>
+template<class Iter>
+void tSubject<T>::detach(Iter first, Iter last)
+{
+    // Slots are only NULLed in the loop, so indices stay valid and the array is compacted at most once at the end
+    for(; first != last; first++)
+    {
+        ObserverType* newOb = *first;
+
+        assert(newOb);
+        assert(isAttached(newOb));
+
+        if (newOb)
+        {
+            size_t index = FindObserver(newOb);
+
+            if (index < mObservers.size())
+            {
+                newOb->InformallyDetachSubject(mObservers[index].mBackIndex);
+                ClearObserverSlot(index);
+            }
+        }
+    }
+
+    RemoveNullObserversIfSparse();
+}
+
+template<class T>
+void tSubject<T>::detachAll()
+{
+    InformallyDetachAllObservers();
+}
+
+template<class T>
+void tSubject<T>::Dispatch(ParamType msg, const bool& subjectDeleted)
+{
+    mNotifyCount = mObservers.size();
+    mCallbackNotifyCount = mCallbacks.size();
+
+    // Indexed rather than iterated, as observers may attach (and grow mObservers) from within update;
+    // mNotifyCount is re-read because moving this subject's links elsewhere cuts the pass short
+    for(size_t i = 0; i < mNotifyCount; i++)
+    {
+        if (mObservers[i].mObserver)
+        {
+            Deliver(i, msg);
+        }
+
+        if (subjectDeleted)
+        {
+            return;
+        }
+    }
+
+    for(size_t i = 0; i < mCallbackNotifyCount; i++)
+    {
+        if (!mCallbacks[i].mCallback.empty())
+        {
+            // Called on a copy: connecting from within the callback may reallocate mCallbacks out from under it
+            tDelegate<T> callback(mCallbacks[i].mCallback);
+            callback(msg);
+        }
+
+        if (subjectDeleted)
+        {
+            return;
+        }
+    }
+}
+
+template<class T>
+void tSubject<T>::Deliver(size_t index, ParamType msg)
+{
+    ObserverType* ob = mObservers[index].mObserver;
+    typename ObserverType::UpdateFunction direct = mObservers[index].mUpdate;
+
+    if (direct)
+    {
+        direct(ob, mObservers[index].mBackIndex, msg);
+    }
+    else
+    {
+        ob->update(msg);
+    }
+}
+
+template<class T>
+void tSubject<T>::DispatchBatch(typename tMessageBatch<T>::Type msgs, size_t count, const bool& subjectDeleted)
+{
+    mNotifyCount = mObservers.size();
+    mCallbackNotifyCount = mCallbacks.size();
+
+    // The same pass as Dispatch, with one call per observer for the whole run
+    for(size_t i = 0; i < mNotifyCount; i++)
+    {
+        ObserverType* ob = mObservers[i].mObserver;
+
+        if (ob && ob->mAcceptsBatches)
+        {
+            ob->updateBatch(msgs, count);
+        }
+        else if (ob)
+        {
+            // Each message may detach ob, delete it, or move this subject's links elsewhere
+            for(size_t m = 0; m < count && i < mNotifyCount && mObservers[i].mObserver == ob; m++)
+            {
+                Deliver(i, msgs[m]);
+
+                if (subjectDeleted)
+                {
+                    return;
+                }
+            }
+        }
+
+        if (subjectDeleted)
+        {
+            return;
+        }
+    }
+
+    for(size_t i = 0; i < mCallbackNotifyCount; i++)
+    {
+        // The bound is re-read after every call, as a callback may move this subject's callables elsewhere
+        for(size_t m = 0; m < count && i < mCallbackNotifyCount && !mCallbacks[i].mCallback.empty(); m++)
+        {
+            tDelegate<T> callback(mCallbacks[i].mCallback);
+            callback(msgs[m]);
+
+            if (subjectDeleted)
+            {
+                return;
+            }
+        }
+    }
+}
+
+template<class T>
+void tSubject<T>::notify(ParamType msg)
+{
+    if (mCurrentlyNotifying && mNestedQueue)
+    {
+        mNestedQueue->push(msg);
+        return;
+    }
+
+    assert(!mCurrentlyNotifying);
+
+    if (!mCurrentlyNotifying)
+    {
+        tDeletionGuard guard(mSubjectDeletedPtr);
+        const bool& subjectDeleted = guard.deleted();
+
+        mCurrentlyNotifying = true;
+
+        Dispatch(msg, subjectDeleted);
+
+        // Not even a member call once the subject is gone
+        if (!subjectDeleted)
+        {
+            FinishNotify(subjectDeleted);
+        }
+    }
+}
+
+template<class T>
+void tSubject<T>::notifyBatch(typename tMessageBatch<T>::Type msgs, size_t count)
+{
+    if (mCurrentlyNotifying && mNestedQueue)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            mNestedQueue->push(msgs[i]);
+        }
+
+        return;
+    }
+
+    assert(!mCurrentlyNotifying);
+
+    if (!mCurrentlyNotifying && count)
+    {
+        tDeletionGuard guard(mSubjectDeletedPtr);
+        const bool& subjectDeleted = guard.deleted();
+
+        mCurrentlyNotifying = true;
+
+        DispatchBatch(msgs, count, subjectDeleted);
+
+        if (!subjectDeleted)
+        {
+            FinishNotify(subjectDeleted);
+        }
+    }
+}
+
+template<class T>
+void tSubject<T>::FinishNotify(const bool& subjectDeleted)
+{
+    // Notifications made during the pass go out afterwards, in order, each with a full pass of its own
+    while (!subjectDeleted && mNestedQueue && mNestedQueue->dispatchNext(*this, subjectDeleted))
+    {
+    }
+
+    if (!subjectDeleted)
+    {
+        mCurrentlyNotifying = false;
+
+        // Observers attached during the pass are already in place past mNotifyCount; only detaches leave work behind
+        if (mNullCount)
+        {
+            RemoveNullObservers();
+        }
+
+        if (mNullCallbackCount)
+        {
+            RemoveNullCallbacks();
+        }
+    }
+}
+
+#if __cplusplus >= 201103L
+template<class T>
+template<class... Args>
+void tSubject<T>::emplaceNotify(Args&&... args)
+{
+    // Built once, here; every observer taking T by reference then sees this very object
+    typename tMessageValue<T>::Type msg(std::forward<Args>(args)...);
+
+    notify(msg);
+}
+#endif
+
+template<class T>
+tConnection tSubject<T>::connect(const tDelegate<T>& callback)
+{
+    assert(!callback.empty());
+
+    tConnection connection;
+
+    if (!callback.empty())
+    {
+        // As with attach, a callable connected during notify is not called until the next one
+        CallbackLink link = { callback, ++mLastConnectionId };
+        mCallbacks.push_back(link);
+
+        connection.mId = link.mId;
+    }
+
+    return connection;
+}
+
+template<class T>
+template<class C>
+tConnection tSubject<T>::connect(C* object, void (C::*method)(T))
+{
+    return connect(tDelegate<T>(object, method));
+}
+
+template<class T>
+void tSubject<T>::disconnect(tConnection& connection)
+{
+    size_t index = FindCallback(connection);
+
+    assert(index < mCallbacks.size());
+
+    if (index < mCallbacks.size())
+    {
+        mCallbacks[index].mCallback = tDelegate<T>();
+        mNullCallbackCount++;
+
+        if (!mCurrentlyNotifying && mNullCallbackCount * 2 > mCallbacks.size())
+        {
+            RemoveNullCallbacks();
+        }
+    }
+
+    connection.mId = 0;
+}
+
+template<class T>
+bool tSubject<T>::isAttached(const ObserverType* ob) const
+{
+    return ob && FindObserver(ob) < mObservers.size();
+}
+
+template<class T>
+void tSubject<T>::setAllocator(tLinkAllocator* allocator)
+{
+    mObservers.setAllocator(allocator);
+    mCallbacks.setAllocator(allocator);
+}
+
+template<class T>
+void tSubject<T>::setQueueNestedNotify(bool queue)
+{
+    // When set, notify() from within an update() is queued and delivered after the current pass instead of asserting
+    assert(!mCurrentlyNotifying);
+
+    if (queue && !mNestedQueue)
+    {
+        mNestedQueue = new NestedQueueImpl<typename tMessageValue<T>::Type>();
+    }
+    else if (!queue)
+    {
+        delete mNestedQueue;
+        mNestedQueue = NULL;
+    }
+}
+
+template<class T, size_t N>
+tSubject<T, N>::tSubject()
+{
+    this->UseInlineStorage(mInlineObservers, N);
+}
+
+template<class T, size_t N>
+tSubject<T, N>::tSubject(const tSubject& other)
+:   BaseType()
+{
+    this->UseInlineStorage(mInlineObservers, N);
+    BaseType::operator=(other);
+}
+
+#if __cplusplus >= 201103L
+template<class T, size_t N>
+tSubject<T, N>::tSubject(tSubject&& other) noexcept
+:   BaseType()
+{
+    this->UseInlineStorage(mInlineObservers, N);
+    BaseType::operator=(std::move(other));
+}
+#endif
+
+template<class T, size_t N>
+tSubject<T, N>::~tSubject()
+{
+    // Unhook observers here, while mInlineObservers is still alive; ~tSubject<T> then finds nothing left to do
+    this->InformallyDetachAllObservers();
+}
+
+template<class T, size_t N>
+tSubject<T, N>& tSubject<T, N>::operator=(const tSubject& other)
+{
+    BaseType::operator=(other);
+    return *this;
+}
+
 #if __cplusplus >= 201103L
-    tSubject& operator=(tSubject&& other);
+template<class T, size_t N>
+tSubject<T, N>& tSubject<T, N>::operator=(tSubject&& other) noexcept
+{
+    BaseType::operator=(std::move(other));
+    return *this;
+}
 #endif
 
-public:
-    void attach(ObserverType* newOb);
-    void detach(ObserverType* newOb);
-    void detachAll();
-    void notify(T msg);
-
-    friend class tObserver<T>;
-};
-
 template<class T>
-class tObserver
+size_t tObserver<T>::InformallyAttachSubject(SubjectType* newSub, size_t backIndex)
 {
-private:
-    typedef tSubject<T>             SubjectType;
-    typedef std::list<SubjectType*> ListType;
+    SubjectLink link = { newSub, backIndex, CreateLinkState() };
 
-private:
-    ListType    mSubjects;
+    mSubjects.push_back(link);
 
-private:
-    void InformallyAttachSubject(SubjectType* newSub);
-    void InformallyDetachSubject(SubjectType* newSub);
-    void InformallyDetachAllSubjects();
-    void FormallyAttachAllSubjects(ListType& newSub);
+    return mSubjects.size() - 1;
+}
 
-public:
-    tObserver();
-    tObserver(const tObserver& other);
-#if __cplusplus >= 201103L
-    tObserver(tObserver&& other);
-#endif
-    virtual ~tObserver();
+template<class T>
+void tObserver<T>::InformallyDetachSubject(size_t index)
+{
+    assert(index < mSubjects.size());
 
-public:
-    tObserver& operator=(const tObserver& other);
-#if __cplusplus >= 201103L
-    tObserver& operator=(tObserver&& other);
-#endif
+    DestroyLinkState(mSubjects[index].mState);
 
-public:
-    virtual void update(T msg) = 0;
+    // Swap-remove; the subject holding the moved link is told where it went
+    if (index != mSubjects.size() - 1)
+    {
+        mSubjects[index] = mSubjects.back();
+        mSubjects[index].mSubject->mObservers[mSubjects[index].mBackIndex].mBackIndex = index;
+    }
 
-    friend class tSubject<T>;
-};
+    mSubjects.pop_back();
+}
 
 template<class T>
-void tSubject<T>::InformallyAttachObserver(ObserverType* newOb)
+void tObserver<T>::InformallyDetachAllSubjects()
 {
-    if (!mCurrentlyNotifying)
+    for(typename ListType::iterator iter = mSubjects.begin(); iter != mSubjects.end(); iter++)
     {
-        mObservers.push_back(newOb);
+        iter->mSubject->InformallyDetachObserver(iter->mBackIndex);
+        DestroyLinkState(iter->mState);
     }
-    else
+
+    mSubjects.clear();
+}
+
+template<class T>
+size_t tObserver<T>::FindSubject(const SubjectType* sub) const
+{
+    for(size_t i = 0; i < mSubjects.size(); i++)
     {
-        mNewObservers.push_back(newOb);
+        if (mSubjects[i].mSubject == sub)
+        {
+            return i;
+        }
     }
+
+    return mSubjects.size();
 }
 
 template<class T>
-void tSubject<T>::InformallyDetachObserver(ObserverType* newOb)
+void tObserver<T>::FormallyAttachAllSubjects(const ListType& newSub)
 {
-    if (!mCurrentlyNotifying)
+    for(typename ListType::const_iterator iter = newSub.begin(); iter != newSub.end(); iter++)
     {
-        mObservers.erase(find(mObservers.begin(), mObservers.end(), newOb));
+        iter->mSubject->attach(this);
     }
-    else
-    {
-        typename ListType::iterator iter = find(mNewObservers.begin(), mNewObservers.end(), newOb);
+}
 
-        if (iter != mNewObservers.end())
-        {
-            mNewObservers.erase(iter);
-        }
-        else
-        {
-            iter = find(mObservers.begin(), mObservers.end(), newOb);
+template<class T>
+void tObserver<T>::TakeSubjects(tObserver& other)
+{
+    mSubjects.takeFrom(other.mSubjects);
 
-            if (iter != mObservers.end())
-            {
-                (*iter) = NULL;
-            }
-        }
+    // Each subject keeps its slot (and so its notification order); only the pointer in it changes hands
+    for(typename ListType::iterator iter = mSubjects.begin(); iter != mSubjects.end(); iter++)
+    {
+        iter->mSubject->mObservers[iter->mBackIndex].mObserver = this;
+        iter->mSubject->mObservers[iter->mBackIndex].mUpdate = mUpdateFunction;
     }
 }
 
 template<class T>
-void tSubject<T>::FormallyAttachIfNotNull(const ListType& observers)
+void tObserver<T>::UseUpdateFunction(UpdateFunction update)
 {
-    for(typename ListType::const_iterator iter = observers.begin() ; iter != observers.end(); iter++)
+    mUpdateFunction = update;
+
+    // Links made before this (by a base class copy or move) still point at the virtual path
+    for(typename ListType::iterator iter = mSubjects.begin(); iter != mSubjects.end(); iter++)
     {
-        if (*iter)
-        {
-            attach(*iter);
-        }
+        iter->mSubject->mObservers[iter->mBackIndex].mUpdate = update;
     }
 }
 
 template<class T>
-void tSubject<T>::FormallyAttach(const ListType& observers)
+void* tObserver<T>::CreateLinkState()
 {
-    for(typename ListType::const_iterator iter = observers.begin() ; iter != observers.end(); iter++)
+    return NULL;
+}
+
+template<class T>
+void tObserver<T>::DestroyLinkState(void* state)
+{
+    assert(!state);
+}
+
+template<class T>
+void tObserver<T>::setAllocator(tLinkAllocator* allocator)
+{
+    mSubjects.setAllocator(allocator);
+}
+
+template<class T>
+void tObserver<T>::AcceptBatches(bool accept)
+{
+    mAcceptsBatches = accept;
+}
+
+template<class T>
+void tObserver<T>::updateBatch(typename tMessageBatch<T>::Type msgs, size_t count)
+{
+    for(size_t i = 0; i < count; i++)
     {
-        attach(*iter);
+        update(msgs[i]);
     }
 }
 
 template<class T>
-tSubject<T>::tSubject()
-:   mCurrentlyNotifying(false),
-mSubjectDeletedPtr(NULL)
+tObserver<T>::tObserver()
+:   mUpdateFunction(NULL),
+mAcceptsBatches(false)
 {
 }
 
 template<class T>
-tSubject<T>::tSubject(const tSubject& other)
-:   mCurrentlyNotifying(false),
-mSubjectDeletedPtr(NULL)
+tObserver<T>::tObserver(const tObserver& other)
+:   mUpdateFunction(NULL),
+mAcceptsBatches(other.mAcceptsBatches)
 {
     if (this != &other)
     {
-        FormallyAttachIfNotNull(other.mObservers);
-        FormallyAttach(other.mNewObservers);
+        FormallyAttachAllSubjects(other.mSubjects);
     }
 }
 
 #if __cplusplus >= 201103L
 template<class T>
-tSubject<T>::tSubject(tSubject&& other)
-:   mCurrentlyNotifying(false),
-mSubjectDeletedPtr(NULL)
+tObserver<T>::tObserver(tObserver&& other) noexcept
+:   mUpdateFunction(NULL),
+mAcceptsBatches(other.mAcceptsBatches)
 {
     if (this != &other)
     {
-        FormallyAttachIfNotNull(other.mObservers);
-        FormallyAttach(other.mNewObservers);
-        other.detachAll();
+        TakeSubjects(other);
     }
 }
 #endif
 
 template<class T>
-tSubject<T>::~tSubject()
+tObserver<T>::~tObserver()
 {
-    if (mSubjectDeletedPtr)
-    {
-        *mSubjectDeletedPtr = true;
-    }
-
-    for(typename ListType::iterator iter = mObservers.begin(); iter != mObservers.end(); iter++)
-    {
-        if (*iter)
-        {
-            (*iter)->InformallyDetachSubject(this);
-        }
-    }
+    InformallyDetachAllSubjects();
 }
 
 template<class T>
-tSubject<T>& tSubject<T>::operator=(const tSubject<T>& other)
+tObserver<T>& tObserver<T>::operator=(const tObserver<T>& other)
 {
     if (this != &other)
     {
-        detachAll();
-
-        FormallyAttachIfNotNull(other.mObservers);
-        FormallyAttach(other.mNewObservers);
+        InformallyDetachAllSubjects();
+        FormallyAttachAllSubjects(other.mSubjects);
     }
 
     return *this;
@@ -240,192 +2081,277 @@ tSubject<T>& tSubject<T>::operator=(const tSubject<T>& other)
 
 #if __cplusplus >= 201103L
 template<class T>
-tSubject<T>& tSubject<T>::operator=(tSubject&& other)
+tObserver<T>& tObserver<T>::operator=(tObserver&& other) noexcept
 {
     if (this != &other)
     {
-        detachAll();
-
-        FormallyAttachIfNotNull(other.mObservers);
-        FormallyAttach(other.mNewObservers);
-
-        other.detachAll();
+        InformallyDetachAllSubjects();
+        TakeSubjects(other);
     }
 
     return *this;
 }
 #endif
 
-template<class T>
-void tSubject<T>::attach(ObserverType* newOb)
+template<class Derived, class T>
+void tStaticObserver<Derived, T>::DirectUpdate(BaseType* ob, size_t, typename tMessageParam<T>::Type msg)
 {
-    assert(newOb);
-    assert(find(mObservers.begin(), mObservers.end(), newOb) == mObservers.end() && find(mNewObservers.begin(), mNewObservers.end(), newOb) == mNewObservers.end());
+#if __cplusplus >= 201402L
+    static_assert(std::is_final<Derived>::value, "tStaticObserver's Derived must be final");
+#endif
 
-    if (newOb)
-    {
-        newOb->InformallyAttachSubject(this);
-        InformallyAttachObserver(newOb);
-    }
+    // Qualified, so this is an ordinary (inlinable) call rather than another trip through the vtable
+    static_cast<Derived*>(ob)->Derived::update(msg);
 }
 
-template<class T>
-void tSubject<T>::detach(ObserverType* newOb)
+template<class Derived, class T>
+tStaticObserver<Derived, T>::tStaticObserver()
 {
-    assert(newOb);
-    assert(find(mObservers.begin(), mObservers.end(), newOb) != mObservers.end() || find(mNewObservers.begin(), mNewObservers.end(), newOb) != mNewObservers.end());
+    this->UseUpdateFunction(&DirectUpdate);
+}
 
-    if (newOb)
-    {
-        newOb->InformallyDetachSubject(this);
-        InformallyDetachObserver(newOb);
-    }
+template<class Derived, class T>
+tStaticObserver<Derived, T>::tStaticObserver(const tStaticObserver& other)
+:   BaseType(other)
+{
+    this->UseUpdateFunction(&DirectUpdate);
+}
+
+#if __cplusplus >= 201103L
+template<class Derived, class T>
+tStaticObserver<Derived, T>::tStaticObserver(tStaticObserver&& other) noexcept
+:   BaseType(std::move(other))
+{
+    this->UseUpdateFunction(&DirectUpdate);
+}
+#endif
+
+template<class Derived, class T>
+tStaticObserver<Derived, T>& tStaticObserver<Derived, T>::operator=(const tStaticObserver& other)
+{
+    BaseType::operator=(other);
+    return *this;
+}
+
+#if __cplusplus >= 201103L
+template<class Derived, class T>
+tStaticObserver<Derived, T>& tStaticObserver<Derived, T>::operator=(tStaticObserver&& other) noexcept
+{
+    BaseType::operator=(std::move(other));
+    return *this;
 }
+#endif
 
 template<class T>
-void tSubject<T>::detachAll()
+size_t tPrioritySubject<T>::FindBucket(int priority) const
 {
-    ListType observersCopy = mObservers;
+    size_t first = 0;
+    size_t last = mBuckets.size();
 
-    for(typename ListType::iterator iter = observersCopy.begin(); iter != observersCopy.end(); iter++)
+    // The first bucket whose priority isn't higher than the one asked for
+    while (first < last)
     {
-        detach(*iter);
-    }
+        size_t middle = first + (last - first) / 2;
 
-    for(typename ListType::iterator iter = mNewObservers.begin(); iter != mNewObservers.end(); iter++)
-    {
-        (*iter)->InformallyDetachSubject(this);
+        if (mBuckets[middle].mPriority > priority)
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
     }
 
-    mNewObservers.clear();
+    return first;
 }
 
 template<class T>
-void tSubject<T>::notify(const T msg)
+typename tPrioritySubject<T>::SubjectType* tPrioritySubject<T>::FindOrAddBucket(int priority)
 {
-    assert(!mCurrentlyNotifying);
+    size_t index = FindBucket(priority);
 
-    if (!mCurrentlyNotifying)
+    if (index == mBuckets.size() || mBuckets[index].mPriority != priority)
     {
-        bool subjectDeleted = false;
+        // Buckets are allocated singly so that they stay put while the array around them shifts
+        Bucket bucket = { priority, new SubjectType() };
+        mBuckets.insert(mBuckets.begin() + index, bucket);
+    }
 
-        mCurrentlyNotifying = true;
-        mSubjectDeletedPtr = &subjectDeleted;
+    return mBuckets[index].mSubject;
+}
 
-        for(typename ListType::iterator iter = mObservers.begin(); iter != mObservers.end(); iter++)
+template<class T>
+typename tPrioritySubject<T>::SubjectType* tPrioritySubject<T>::FindObserverBucket(const ObserverType* ob) const
+{
+    for(typename BucketList::const_iterator iter = mBuckets.begin(); iter != mBuckets.end(); iter++)
+    {
+        if (iter->mSubject->isAttached(ob))
         {
-            if (*iter)
-            {
-                (*iter)->update(msg);
-            }
-
-            if (subjectDeleted)
-            {
-                break;
-            }
+            return iter->mSubject;
         }
+    }
 
-        if (!subjectDeleted)
-        {
-            mSubjectDeletedPtr = NULL;
-            mCurrentlyNotifying = false;
+    return NULL;
+}
 
-            mObservers.remove(NULL);
-            mObservers.insert(mObservers.end(), mNewObservers.begin(), mNewObservers.end());
-            mNewObservers.clear();
-        }
-    }
+template<class T>
+tPrioritySubject<T>::tPrioritySubject()
+:   mCurrentlyNotifying(false),
+mSubjectDeletedPtr(NULL)
+{
 }
 
 template<class T>
-void tObserver<T>::InformallyAttachSubject(SubjectType* newSub)
+tPrioritySubject<T>::~tPrioritySubject()
 {
-    mSubjects.push_back(newSub);
+    if (mSubjectDeletedPtr)
+    {
+        *mSubjectDeletedPtr = true;
+    }
+
+    for(typename BucketList::iterator iter = mBuckets.begin(); iter != mBuckets.end(); iter++)
+    {
+        delete iter->mSubject;
+    }
 }
 
 template<class T>
-void tObserver<T>::InformallyDetachSubject(SubjectType* newSub)
+void tPrioritySubject<T>::attach(ObserverType* newOb, int priority)
 {
-    mSubjects.erase(find(mSubjects.begin(), mSubjects.end(), newSub));
+    assert(!isAttached(newOb));
+
+    FindOrAddBucket(priority)->attach(newOb);
 }
 
 template<class T>
-void tObserver<T>::InformallyDetachAllSubjects()
+void tPrioritySubject<T>::detach(ObserverType* newOb)
 {
-    for(typename ListType::iterator iter = mSubjects.begin(); iter != mSubjects.end(); iter++)
+    SubjectType* bucket = FindObserverBucket(newOb);
+
+    assert(bucket);
+
+    if (bucket)
     {
-        (*iter)->InformallyDetachObserver(this);
+        bucket->detach(newOb);
     }
-
-    mSubjects.clear();
 }
 
 template<class T>
-void tObserver<T>::FormallyAttachAllSubjects(ListType& newSub)
+void tPrioritySubject<T>::detachAll()
 {
-    for(typename ListType::iterator iter = newSub.begin(); iter != newSub.end(); iter++)
+    for(typename BucketList::iterator iter = mBuckets.begin(); iter != mBuckets.end(); iter++)
     {
-        (*iter)->attach(this);
+        iter->mSubject->detachAll();
     }
 }
 
 template<class T>
-tObserver<T>::tObserver()
+tConnection tPrioritySubject<T>::connect(const tDelegate<T>& callback, int priority)
 {
+    return FindOrAddBucket(priority)->connect(callback);
 }
 
 template<class T>
-tObserver<T>::tObserver(const tObserver& other)
+void tPrioritySubject<T>::disconnect(tConnection& connection, int priority)
 {
-    if (this != &other)
+    size_t index = FindBucket(priority);
+
+    assert(index < mBuckets.size() && mBuckets[index].mPriority == priority);
+
+    if (index < mBuckets.size() && mBuckets[index].mPriority == priority)
     {
-        ListType subjects(other.mSubjects);
-        FormallyAttachAllSubjects(subjects);
+        mBuckets[index].mSubject->disconnect(connection);
     }
 }
 
-#if __cplusplus >= 201103L
 template<class T>
-tObserver<T>::tObserver(tObserver&& other)
+void tPrioritySubject<T>::notify(ParamType msg)
 {
-    if (this != &other)
+    assert(!mCurrentlyNotifying);
+
+    if (!mCurrentlyNotifying)
     {
-        FormallyAttachAllSubjects(other.mSubjects);
-        other.InformallyDetachAllSubjects();
+        tDeletionGuard guard(mSubjectDeletedPtr);
+        const bool& subjectDeleted = guard.deleted();
+
+        mCurrentlyNotifying = true;
+
+        // Each next bucket is found by priority rather than index, as attaching from within update may insert buckets
+        for(size_t i = 0; i < mBuckets.size(); )
+        {
+            int priority = mBuckets[i].mPriority;
+
+            mBuckets[i].mSubject->notify(msg);
+
+            if (subjectDeleted)
+            {
+                return;
+            }
+
+            i = FindBucket(priority) + 1;
+        }
+
+        mCurrentlyNotifying = false;
     }
 }
-#endif
 
 template<class T>
-tObserver<T>::~tObserver()
+bool tPrioritySubject<T>::isAttached(const ObserverType* ob) const
 {
-    InformallyDetachAllSubjects();
+    return FindObserverBucket(ob) != NULL;
 }
 
-template<class T>
-tObserver<T>& tObserver<T>::operator=(const tObserver<T>& other)
+#if __cplusplus >= 201703L
+template<class T, class... Observers>
+template<class Observer>
+bool tStaticSubject<T, Observers...>::UpdateEach(Observer& ob, typename tMessageBatch<T>::Type msgs, size_t count, const bool& subjectDeleted)
 {
-    if (this != &other)
+    for(size_t i = 0; i < count && !subjectDeleted; i++)
     {
-        InformallyDetachAllSubjects();
-        ListType subjects(other.mSubjects);
-        FormallyAttachAllSubjects(subjects);
+        ob.Observer::update(msgs[i]);
     }
 
-    return *this;
+    return !subjectDeleted;
 }
 
-#if __cplusplus >= 201103L
-template<class T>
-tObserver<T>& tObserver<T>::operator=(tObserver&& other)
+template<class T, class... Observers>
+tStaticSubject<T, Observers...>::tStaticSubject(Observers&... observers)
+:   mStaticObservers(observers...)
 {
-    if (this != &other)
+}
+
+template<class T, class... Observers>
+void tStaticSubject<T, Observers...>::Dispatch(ParamType msg, const bool& subjectDeleted)
+{
+    std::apply([&msg, &subjectDeleted](Observers&... observers)
     {
-        InformallyDetachAllSubjects();
-        FormallyAttachAllSubjects(other.mSubjects);
-        other.InformallyDetachAllSubjects();
+        // Qualified, so even a virtual update resolves at compile time; the fold stops at one that deletes the subject
+        (void)((observers.Observers::update(msg), !subjectDeleted) && ...);
+    }, mStaticObservers);
+
+    if (subjectDeleted)
+    {
+        return;
     }
 
-    return *this;
+    BaseType::Dispatch(msg, subjectDeleted);
+}
+
+template<class T, class... Observers>
+void tStaticSubject<T, Observers...>::DispatchBatch(typename tMessageBatch<T>::Type msgs, size_t count, const bool& subjectDeleted)
+{
+    std::apply([msgs, count, &subjectDeleted](Observers&... observers)
+    {
+        // Observer by observer, as tSubject does
+        (void)(UpdateEach(observers, msgs, count, subjectDeleted) && ...);
+    }, mStaticObservers);
+
+    if (subjectDeleted)
+    {
+        return;
+    }
+
+    BaseType::DispatchBatch(msgs, count, subjectDeleted);
 }
 #endif
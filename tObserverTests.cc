@@ -98,12 +98,37 @@ public:
     }
 };
 
+class tOTStaticObserver
+#if __cplusplus >= 201103L
+final
+#endif
+: public tStaticObserver<tOTStaticObserver, const size_t&>
+{
+protected:
+    size_t mBase;
+
+public:
+    tOTStaticObserver(size_t base) : mBase(base) { }
+
+    void setBase(size_t base)
+    {
+        mBase = base;
+    }
+
+    virtual void update(const size_t& msg)
+    {
+        tOTNotifications.push_back(msg + mBase);
+    }
+};
+
 class tObserverTests
 {
 public:
 	tObserverTests()
 	{
         testUpdate();
+        testMultipleSubjects();
+        testStaticObserver();
 
         testCopyCtor();
 		testCopyAssign();
@@ -142,6 +167,100 @@ public:
         printf("*** ::testUpdate passed\n");
     }
 
+    void testMultipleSubjects()
+    {
+        size_t expectedResult[] =
+        {
+            11, 21,
+            22, 12,
+            13, 23,
+            14, 24,
+            15,
+        };
+
+        tOTSubject sourceA;
+        tOTSubject* sourceB = new tOTSubject;
+        tOTSubject sourceC;
+        tOTObserver listener(10);
+        tOTObserver* listener2 = new tOTObserver(20);
+
+        tOTNotifications.clear();
+
+        sourceA.attach(&listener);
+        sourceA.attach(listener2);
+        sourceB->attach(listener2);
+        sourceB->attach(&listener);
+        sourceC.attach(&listener);
+        sourceC.attach(listener2);
+
+        sourceA.notify(1);
+        sourceB->notify(2);
+        delete sourceB;
+        sourceC.notify(3);
+        sourceC.detach(&listener);
+        sourceA.notify(4);
+        delete listener2;
+        sourceA.notify(5);
+        sourceC.notify(6);
+
+        assert(tOTNotifications.size() == sizeof(expectedResult) / sizeof(size_t));
+
+        if (tOTNotifications.size() == sizeof(expectedResult) / sizeof(size_t))
+        {
+            for (size_t i = 0; i < sizeof(expectedResult) / sizeof(size_t); i++)
+            {
+                assert(tOTNotifications[i] == expectedResult[i]);
+            }
+        }
+
+        printf("*** ::testMultipleSubjects passed\n");
+    }
+
+    void testStaticObserver()
+    {
+        size_t expectedResult[] =
+        {
+            11, 2,
+            12, 3, 22,
+                4, 23,
+                5, 34,
+        };
+
+        tOTSubject source;
+        tOTStaticObserver listener(10);
+        tOTObserver plainListener(1);
+
+        tOTNotifications.clear();
+
+        source.attach(&listener);
+        source.attach(&plainListener);
+        source.notify(1);
+
+        tOTStaticObserver listener2 = listener;
+        listener2.setBase(20);
+        source.notify(2);
+        source.detach(&listener);
+        source.notify(3);
+
+        tOTStaticObserver listener3(30);
+        listener3 = listener2;
+        listener3.setBase(30);
+        source.detach(&listener2);
+        source.notify(4);
+
+        assert(tOTNotifications.size() == sizeof(expectedResult) / sizeof(size_t));
+
+        if (tOTNotifications.size() == sizeof(expectedResult) / sizeof(size_t))
+        {
+            for (size_t i = 0; i < sizeof(expectedResult) / sizeof(size_t); i++)
+            {
+                assert(tOTNotifications[i] == expectedResult[i]);
+            }
+        }
+
+        printf("*** ::testStaticObserver passed\n");
+    }
+
     void testCopyCtor()
     {
         size_t expectedResult[] =
@@ -0,0 +1,517 @@
+/*
+ Observer Template (C++) by TJ Grant (tjgrant@tatewake.com)
+
+ tParallelSubject: a subject that can fan a message out across a pool of threads.
+
+ //--
+
+ Copyright (c) 2011-02-01 TJ Grant (tjgrant@tatewake.com)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#pragma once
+
+#include "tObserver.h"
+
+#if __cplusplus >= 201103L
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#endif
+
+#if __cplusplus >= 201103L
+// Threads for tParallelSubject::parallelNotify(). run() splits a job into numbered chunks dealt out across per-thread
+// queues; each thread works through its own queue from the back and, once that's empty, steals from the front of
+// the others'. The calling thread joins in, and run() returns once every chunk is done. One job runs at a time.
+class tWorkStealingPool
+{
+public:
+    typedef void (*ChunkFunction)(void* context, size_t chunk);
+
+private:
+    struct Queue
+    {
+        std::mutex          mMutex;
+        std::deque<size_t>  mChunks;
+    };
+
+private:
+    std::vector<std::thread>    mThreads;
+    Queue*                      mQueues;            // one per thread, plus one for the caller of run()
+    size_t                      mQueueCount;
+
+    std::mutex                  mJobMutex;
+    ChunkFunction               mFunction;
+    void*                       mContext;
+    std::atomic<size_t>         mRemaining;
+
+    std::mutex                  mWakeMutex;
+    std::condition_variable     mWake;
+    std::condition_variable     mDone;
+    size_t                      mGeneration;
+    bool                        mShutdown;
+
+private:
+    bool RunOne(size_t self);
+    void WorkerLoop(size_t self);
+
+public:
+    explicit tWorkStealingPool(size_t threadCount = 0);     // 0: one less than the hardware has
+    tWorkStealingPool(const tWorkStealingPool& other) = delete;
+    ~tWorkStealingPool();
+
+public:
+    tWorkStealingPool& operator=(const tWorkStealingPool& other) = delete;
+
+public:
+    size_t threadCount() const      { return mThreads.size(); }
+    void run(size_t chunkCount, ChunkFunction function, void* context);
+};
+
+// A subject that can fan a message out across a tWorkStealingPool. Observers opt in to being called concurrently by
+// attaching with attachConcurrent(); parallelNotify() first notifies the ordinary observers in order, as notify()
+// does, then splits the concurrent ones into chunks for the pool. Plain notify() reaches both, sequentially, and so
+// does a notify through a tSubject<T>&. Each message, queued nested ones included, reaches the concurrent observers
+// before the next one starts; those queued during parallelNotify are fanned out across the same pool.
+// While the pool is at work the concurrent observers' links are never touched: attachConcurrent and detachConcurrent
+// from within update() are queued and take effect before parallelNotify returns. A concurrent observer detached during
+// that phase is flagged at once and skipped from then on, though an update already under way on another thread can't
+// be recalled. Concurrent observers mustn't be destroyed during it, nor may they
+// delete the subject; ordinary observers may, as with tSubject.
+template<class T>
+class tParallelSubject
+: public tSubject<T>
+{
+private:
+    typedef tSubject<T>                         BaseType;
+    typedef tObserver<T>                        ObserverType;
+    typedef typename tMessageParam<T>::Type     ParamType;
+
+    enum { kMinChunkSize = 64 };
+
+    struct PendingChange
+    {
+        ObserverType*   mObserver;
+        bool            mAttach;
+    };
+
+    struct Job
+    {
+        tParallelSubject*                                       mSubject;
+        typename std::remove_reference<ParamType>::type*        mMessage;
+        size_t                                                  mChunkSize;
+    };
+
+private:
+    BaseType                    mConcurrentObservers;
+    std::atomic<bool>           mParallelPhase;
+    std::mutex                  mPendingMutex;
+    std::vector<PendingChange>  mPending;
+    std::atomic<bool>*          mDetached;          // one per concurrent link, for the parallel phase
+    size_t                      mDetachedCapacity;
+    tWorkStealingPool*          mPool;              // set for the length of a parallelNotify
+
+private:
+    static void NotifyChunk(void* context, size_t chunk);
+    bool QueueIfParallel(ObserverType* ob, bool attach);
+    void ApplyPending();
+    void NotifyConcurrently(tWorkStealingPool& pool, ParamType msg);
+
+protected:
+    virtual void Dispatch(ParamType msg, const bool& subjectDeleted);
+
+    // The ordinary observers take the whole run as tSubject does, then the concurrent ones, sequentially
+    virtual void DispatchBatch(typename tMessageBatch<T>::Type msgs, size_t count, const bool& subjectDeleted);
+
+public:
+    tParallelSubject();
+    tParallelSubject(const tParallelSubject& other) = delete;
+    virtual ~tParallelSubject();
+
+public:
+    tParallelSubject& operator=(const tParallelSubject& other) = delete;
+
+public:
+    void attachConcurrent(ObserverType* newOb);
+    void detachConcurrent(ObserverType* newOb);
+    bool isAttachedConcurrent(const ObserverType* ob) const;
+
+    void parallelNotify(tWorkStealingPool& pool, ParamType msg);
+};
+#endif
+
+#if __cplusplus >= 201103L
+inline tWorkStealingPool::tWorkStealingPool(size_t threadCount)
+:   mQueues(NULL),
+mQueueCount(0),
+mFunction(NULL),
+mContext(NULL),
+mRemaining(0),
+mGeneration(0),
+mShutdown(false)
+{
+    if (threadCount == 0)
+    {
+        size_t hardware = std::thread::hardware_concurrency();
+        threadCount = (hardware > 1) ? hardware - 1 : 1;
+    }
+
+    mQueueCount = threadCount + 1;
+    mQueues = new Queue[mQueueCount];
+
+    for(size_t i = 0; i < threadCount; i++)
+    {
+        mThreads.push_back(std::thread(&tWorkStealingPool::WorkerLoop, this, i));
+    }
+}
+
+inline tWorkStealingPool::~tWorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mShutdown = true;
+    }
+
+    mWake.notify_all();
+
+    for(size_t i = 0; i < mThreads.size(); i++)
+    {
+        mThreads[i].join();
+    }
+
+    delete[] mQueues;
+}
+
+inline bool tWorkStealingPool::RunOne(size_t self)
+{
+    size_t chunk = 0;
+    bool found = false;
+
+    // Own queue from the back, where the most recently dealt (and so most likely cached) chunks are...
+    {
+        std::lock_guard<std::mutex> lock(mQueues[self].mMutex);
+
+        if (!mQueues[self].mChunks.empty())
+        {
+            chunk = mQueues[self].mChunks.back();
+            mQueues[self].mChunks.pop_back();
+            found = true;
+        }
+    }
+
+    // ...then everyone else's from the front
+    for(size_t i = 1; !found && i < mQueueCount; i++)
+    {
+        Queue& victim = mQueues[(self + i) % mQueueCount];
+        std::lock_guard<std::mutex> lock(victim.mMutex);
+
+        if (!victim.mChunks.empty())
+        {
+            chunk = victim.mChunks.front();
+            victim.mChunks.pop_front();
+            found = true;
+        }
+    }
+
+    if (found)
+    {
+        mFunction(mContext, chunk);
+
+        if (mRemaining.fetch_sub(1) == 1)
+        {
+            std::lock_guard<std::mutex> lock(mWakeMutex);
+            mDone.notify_all();
+        }
+    }
+
+    return found;
+}
+
+inline void tWorkStealingPool::WorkerLoop(size_t self)
+{
+    size_t generation = 0;
+
+    for(;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mWakeMutex);
+
+            while (!mShutdown && generation == mGeneration)
+            {
+                mWake.wait(lock);
+            }
+
+            if (mShutdown)
+            {
+                return;
+            }
+
+            generation = mGeneration;
+        }
+
+        while (RunOne(self))
+        {
+        }
+    }
+}
+
+inline void tWorkStealingPool::run(size_t chunkCount, ChunkFunction function, void* context)
+{
+    if (chunkCount == 0)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> jobLock(mJobMutex);
+
+    mFunction = function;
+    mContext = context;
+    mRemaining.store(chunkCount);
+
+    // Dealt out in contiguous runs, so each thread starts on neighbouring chunks
+    for(size_t queue = 0; queue < mQueueCount; queue++)
+    {
+        std::lock_guard<std::mutex> lock(mQueues[queue].mMutex);
+
+        for(size_t chunk = queue * chunkCount / mQueueCount; chunk < (queue + 1) * chunkCount / mQueueCount; chunk++)
+        {
+            mQueues[queue].mChunks.push_front(chunk);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mGeneration++;
+    }
+
+    mWake.notify_all();
+
+    while (RunOne(mQueueCount - 1))
+    {
+    }
+
+    std::unique_lock<std::mutex> lock(mWakeMutex);
+
+    while (mRemaining.load() != 0)
+    {
+        mDone.wait(lock);
+    }
+}
+
+template<class T>
+tParallelSubject<T>::tParallelSubject()
+:   mParallelPhase(false),
+mDetached(NULL),
+mDetachedCapacity(0),
+mPool(NULL)
+{
+}
+
+template<class T>
+tParallelSubject<T>::~tParallelSubject()
+{
+    delete[] mDetached;
+}
+
+template<class T>
+void tParallelSubject<T>::NotifyChunk(void* context, size_t chunk)
+{
+    const Job* job = static_cast<const Job*>(context);
+    typename BaseType::ListType& links = job->mSubject->mConcurrentObservers.mObservers;
+
+    size_t first = chunk * job->mChunkSize;
+    size_t last = std::min(first + job->mChunkSize, links.size());
+
+    for(size_t i = first; i < last; i++)
+    {
+        ObserverType* ob = links[i].mObserver;
+
+        if (ob && !job->mSubject->mDetached[i].load(std::memory_order_acquire))
+        {
+            if (links[i].mUpdate)
+            {
+                links[i].mUpdate(ob, links[i].mBackIndex, *job->mMessage);
+            }
+            else
+            {
+                ob->update(*job->mMessage);
+            }
+        }
+    }
+}
+
+template<class T>
+bool tParallelSubject<T>::QueueIfParallel(ObserverType* ob, bool attach)
+{
+    if (!mParallelPhase.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    PendingChange change = { ob, attach };
+
+    std::lock_guard<std::mutex> lock(mPendingMutex);
+    mPending.push_back(change);
+
+    return true;
+}
+
+template<class T>
+void tParallelSubject<T>::ApplyPending()
+{
+    std::lock_guard<std::mutex> lock(mPendingMutex);
+
+    // In the order they were made; one observer may well have been attached and then detached again
+    for(typename std::vector<PendingChange>::const_iterator iter = mPending.begin(); iter != mPending.end(); iter++)
+    {
+        if (iter->mAttach)
+        {
+            mConcurrentObservers.attach(iter->mObserver);
+        }
+        else
+        {
+            mConcurrentObservers.detach(iter->mObserver);
+        }
+    }
+
+    mPending.clear();
+}
+
+template<class T>
+void tParallelSubject<T>::NotifyConcurrently(tWorkStealingPool& pool, ParamType msg)
+{
+    assert(!mParallelPhase.load());
+
+    size_t count = mConcurrentObservers.mObservers.size();
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    // A few chunks per thread, so that stealing has something to even out, but never so small that it's all overhead
+    size_t chunkSize = std::max<size_t>(kMinChunkSize, count / ((pool.threadCount() + 1) * 4));
+    Job job = { this, &msg, chunkSize };
+
+    if (mDetachedCapacity < count)
+    {
+        delete[] mDetached;
+        mDetached = new std::atomic<bool>[count];
+        mDetachedCapacity = count;
+    }
+
+    for(size_t i = 0; i < count; i++)
+    {
+        mDetached[i].store(false, std::memory_order_relaxed);
+    }
+
+    mParallelPhase.store(true, std::memory_order_release);
+
+    pool.run((count + chunkSize - 1) / chunkSize, &NotifyChunk, &job);
+
+    mParallelPhase.store(false, std::memory_order_release);
+
+    ApplyPending();
+}
+
+template<class T>
+void tParallelSubject<T>::Dispatch(ParamType msg, const bool& subjectDeleted)
+{
+    BaseType::Dispatch(msg, subjectDeleted);
+
+    if (subjectDeleted)
+    {
+        return;
+    }
+
+    if (mPool)
+    {
+        NotifyConcurrently(*mPool, msg);
+    }
+    else
+    {
+        mConcurrentObservers.notify(msg);
+    }
+}
+
+template<class T>
+void tParallelSubject<T>::DispatchBatch(typename tMessageBatch<T>::Type msgs, size_t count, const bool& subjectDeleted)
+{
+    BaseType::DispatchBatch(msgs, count, subjectDeleted);
+
+    if (subjectDeleted)
+    {
+        return;
+    }
+
+    mConcurrentObservers.notifyBatch(msgs, count);
+}
+
+template<class T>
+void tParallelSubject<T>::attachConcurrent(ObserverType* newOb)
+{
+    if (!QueueIfParallel(newOb, true))
+    {
+        mConcurrentObservers.attach(newOb);
+    }
+}
+
+template<class T>
+void tParallelSubject<T>::detachConcurrent(ObserverType* newOb)
+{
+    if (!QueueIfParallel(newOb, false))
+    {
+        mConcurrentObservers.detach(newOb);
+        return;
+    }
+
+    // The links stay put until the phase is over, so the one to skip can be looked up from any thread meanwhile
+    size_t index = mConcurrentObservers.FindObserver(newOb);
+
+    if (index < mConcurrentObservers.mObservers.size())
+    {
+        mDetached[index].store(true, std::memory_order_release);
+    }
+}
+
+template<class T>
+bool tParallelSubject<T>::isAttachedConcurrent(const ObserverType* ob) const
+{
+    return mConcurrentObservers.isAttached(ob);
+}
+
+template<class T>
+void tParallelSubject<T>::parallelNotify(tWorkStealingPool& pool, ParamType msg)
+{
+    // Called from within a pass, this only queues msg (see setQueueNestedNotify); the outer pass keeps its own pool
+    tDeletionGuard guard(this->mSubjectDeletedPtr);
+    tWorkStealingPool* outerPool = mPool;
+
+    mPool = &pool;
+
+    BaseType::notify(msg);
+
+    if (!guard.deleted())
+    {
+        mPool = outerPool;
+    }
+}
+#endif
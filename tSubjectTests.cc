@@ -29,9 +29,24 @@
 #include <vector>
 
 #include "tObserver.h"
+#include "tKeyedSubject.h"
+#include "tConflatingSubject.h"
+#include "tConcurrentSubject.h"
+#include "tAsyncSubject.h"
+#include "tParallelSubject.h"
+#include "tMailboxObserver.h"
+#include "tVariantSubject.h"
+#include "tAwaitableSubject.h"
 
 #if __cplusplus >= 201103L
 #include <utility>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#endif
+
+#if __cplusplus >= 202002L
+#include <exception>
 #endif
 
 static std::vector<size_t> tSTNotifications;
@@ -146,6 +161,26 @@ public:
     }
 };
 
+// For subjects that don't expose their tSubject base
+template<class S>
+class tDeleteOnUpdateTestClass
+: public tObserver<const size_t&>
+{
+protected:
+    S*  mSubject;
+
+public:
+    tDeleteOnUpdateTestClass(S* sub) : mSubject(sub) { }
+    virtual ~tDeleteOnUpdateTestClass() { }
+
+    virtual void update(const size_t& msg)
+    {
+#pragma unused(msg)
+        assert(mSubject);
+        delete mSubject;
+    }
+};
+
 class AttachNewDuringNotify
 : public tObserver<const size_t&>
 {
@@ -244,6 +279,291 @@ public:
     }
 };
 
+class NotifyDuringNotify
+: public tObserver<const size_t&>
+{
+public:
+    tSubject<const size_t&>* mSubject;
+    size_t mTrigger;
+
+public:
+    NotifyDuringNotify(tSubject<const size_t&>* newSubject, size_t newTrigger) : mSubject(newSubject), mTrigger(newTrigger) { }
+
+    virtual void update(const size_t& msg)
+    {
+        tSTNotifications.push_back(100 + msg);
+
+        if (msg < mTrigger)
+        {
+            // Passed as a temporary; the queue has to keep its own copy
+            mSubject->notify(msg + 1);
+        }
+    }
+};
+
+
+class tCopyCountingMessage
+{
+public:
+    static size_t sCopies;
+    size_t mValue;
+
+public:
+    tCopyCountingMessage(size_t value) : mValue(value) { }
+    tCopyCountingMessage(const tCopyCountingMessage& other) : mValue(other.mValue) { sCopies++; }
+};
+
+size_t tCopyCountingMessage::sCopies = 0;
+
+class tCopyCountingByRefObserver
+: public tObserver<const tCopyCountingMessage&>
+{
+public:
+    virtual void update(const tCopyCountingMessage& msg)
+    {
+        tSTNotifications.push_back(msg.mValue);
+    }
+};
+
+class tCopyCountingByValueObserver
+: public tObserver<tCopyCountingMessage>
+{
+public:
+    virtual void update(tCopyCountingMessage msg)
+    {
+        tSTNotifications.push_back(msg.mValue);
+    }
+};
+
+class tBatchObserverTestClass
+: public tObserver<const size_t&>
+{
+public:
+    tBatchObserverTestClass() { AcceptBatches(); }
+
+    virtual void update(const size_t& msg)
+    {
+        tSTNotifications.push_back(msg);
+    }
+
+    virtual void updateBatch(const size_t* msgs, size_t count)
+    {
+        size_t sum = 0;
+
+        for(size_t i = 0; i < count; i++)
+        {
+            sum += msgs[i];
+        }
+
+        tSTNotifications.push_back(1000 + sum);
+    }
+};
+
+// Takes the first message of a run itself and hands the rest to the default updateBatch()
+class tPartialBatchObserverTestClass
+: public tObserver<const size_t&>
+{
+public:
+    tPartialBatchObserverTestClass() { AcceptBatches(); }
+
+    virtual void update(const size_t& msg)
+    {
+        tSTNotifications.push_back(msg);
+    }
+
+    virtual void updateBatch(const size_t* msgs, size_t count)
+    {
+        tSTNotifications.push_back(999);
+        tObserver<const size_t&>::updateBatch(msgs + 1, count - 1);
+    }
+};
+
+static void tSTCallbackFunction(const size_t& msg)
+{
+    tSTNotifications.push_back(msg + 100);
+}
+
+class tCallbackTargetTestClass
+{
+protected:
+    size_t mBase;
+
+public:
+    tCallbackTargetTestClass(size_t base) : mBase(base) { }
+
+    void record(const size_t& msg)
+    {
+        tSTNotifications.push_back(msg + mBase);
+    }
+};
+
+struct tKeyOfTestClass
+{
+    size_t operator()(const size_t& msg) const
+    {
+        return msg % 10;
+    }
+};
+
+#if __cplusplus >= 201103L
+class tCountingObserverTestClass
+: public tObserver<const size_t&>
+{
+public:
+    std::atomic<size_t> mCount;
+
+public:
+    tCountingObserverTestClass() : mCount(0) { }
+
+    virtual void update(const size_t& msg)
+    {
+        mCount.fetch_add(msg);
+    }
+};
+
+class tDetachConcurrentOnUpdateTestClass
+: public tObserver<const size_t&>
+{
+public:
+    tParallelSubject<const size_t&>* mSubject;
+    tObserver<const size_t&>* mTarget;
+    std::atomic<size_t> mCount;
+
+public:
+    tDetachConcurrentOnUpdateTestClass(tParallelSubject<const size_t&>* subject, tObserver<const size_t&>* target = NULL)
+    : mSubject(subject), mTarget(target ? target : this), mCount(0) { }
+
+    virtual void update(const size_t& msg)
+    {
+        mCount.fetch_add(msg);
+        mSubject->detachConcurrent(mTarget);
+    }
+};
+
+class tMailboxTestClass
+: public tMailboxObserver<const size_t&>
+{
+public:
+    bool mRecord;
+    size_t mLast;
+    size_t mLastOf[2];      // odd and even messages are checked for order separately, as they may come from two subjects
+    size_t mCount;
+    bool mInOrder;
+
+public:
+    tMailboxTestClass(size_t capacity, bool record) : tMailboxObserver<const size_t&>(capacity), mRecord(record), mLast(0), mCount(0), mInOrder(true) { mLastOf[0] = mLastOf[1] = 0; }
+
+    virtual void update(const size_t& msg)
+    {
+        if (mRecord)
+        {
+            tSTNotifications.push_back(msg);
+        }
+
+        mInOrder = mInOrder && msg > mLastOf[msg % 2];
+        mLastOf[msg % 2] = msg;
+        mLast = msg;
+        mCount++;
+    }
+};
+
+class tDetachingMailboxTestClass
+: public tMailboxObserver<const size_t&>
+{
+public:
+    tSubject<const size_t&>* mSubject;
+
+public:
+    tDetachingMailboxTestClass(tSubject<const size_t&>* sub) : mSubject(sub) { }
+
+    virtual void update(const size_t& msg)
+    {
+        tSTNotifications.push_back(msg);
+
+        if (mSubject->isAttached(this))
+        {
+            mSubject->detach(this);
+        }
+    }
+};
+#endif
+
+#if __cplusplus >= 202002L
+// Fire-and-forget coroutine: runs until its first suspension, and cleans up after itself when it finishes
+struct tAwaitTestTask
+{
+    struct promise_type
+    {
+        tAwaitTestTask get_return_object()          { return tAwaitTestTask(); }
+        std::suspend_never initial_suspend()        { return std::suspend_never(); }
+        std::suspend_never final_suspend() noexcept { return std::suspend_never(); }
+        void return_void()                          { }
+        void unhandled_exception()                  { std::terminate(); }
+    };
+};
+
+static tAwaitTestTask tSTAwaitMessages(tAwaitableSubject<const size_t&>& subject, size_t base, size_t count)
+{
+    tAwaitableSubject<const size_t&>::Cursor cursor(subject);
+
+    for(size_t i = 0; i < count; i++)
+    {
+        size_t msg = co_await cursor.next();
+        tSTNotifications.push_back(msg + base);
+    }
+}
+
+static tAwaitTestTask tSTAwaitThenDelete(tAwaitableSubject<const size_t&>* subject)
+{
+    tAwaitableSubject<const size_t&>::Cursor cursor(*subject);
+
+    size_t msg = co_await cursor.next();
+    tSTNotifications.push_back(msg);
+
+    delete subject;
+}
+
+static tAwaitTestTask tSTAwaitCursor(tAwaitableSubject<const size_t&>::Cursor& cursor, size_t count)
+{
+    for(size_t i = 0; i < count; i++)
+    {
+        size_t msg = co_await cursor.next();
+        tSTNotifications.push_back(msg);
+    }
+}
+#endif
+
+#if __cplusplus < 201103L
+class tCallbackFunctorTestClass
+{
+protected:
+    size_t mBase;
+
+public:
+    tCallbackFunctorTestClass(size_t base) : mBase(base) { }
+
+    void operator()(const size_t& msg) const
+    {
+        tSTNotifications.push_back(msg + mBase);
+    }
+};
+#endif
+
+#if __cplusplus >= 201703L
+class tStaticHandlerTestClass
+{
+protected:
+    size_t mBase;
+
+public:
+    tStaticHandlerTestClass(size_t base) : mBase(base) { }
+
+    void update(const size_t& msg)
+    {
+        tSTNotifications.push_back(msg + mBase);
+    }
+};
+#endif
 
 class tObserverCopyCtorXDuringNotifyXTestClass
 : public tObserver<const size_t&>
@@ -347,6 +667,30 @@ public:
 };
 #endif
 
+class tCountingAllocatorTestClass
+: public tFixedSizePool
+{
+public:
+    size_t mOutstanding;
+    size_t mAllocations;
+
+public:
+    tCountingAllocatorTestClass() : tFixedSizePool(64, 8), mOutstanding(0), mAllocations(0) { }
+
+    virtual void* allocate(size_t& bytes)
+    {
+        mOutstanding++;
+        mAllocations++;
+        return tFixedSizePool::allocate(bytes);
+    }
+
+    virtual void deallocate(void* ptr, size_t bytes)
+    {
+        mOutstanding--;
+        tFixedSizePool::deallocate(ptr, bytes);
+    }
+};
+
 class tSubjectTests
 {
 public:
@@ -362,12 +706,39 @@ public:
         testAttachDetachAttachDuringNotify();
         testAttachDetachAllAttachDuringNotify();
 
+        testDetachManyKeepsOrder();
+        testInlineStorage();
+        testIsAttached();
+        testAllocator();
+        testBulkAttachDetach();
+        testNotifyDuringNotify();
+        testNotifyCopies();
+        testNotifyBatch();
+        testConnect();
+        testKeyedSubject();
+        testPrioritySubject();
+        testConflatingSubject();
+
+#if __cplusplus >= 201703L
+        testStaticSubject();
+        testVariantSubject();
+#endif
+
+#if __cplusplus >= 202002L
+        testAwaitableSubject();
+#endif
+
         testCopyCtor();
         testCopyAssign();
 
 #if __cplusplus >= 201103L
         testMoveCtor();
         testMoveAssign();
+        testMoveInVector();
+        testConcurrentSubject();
+        testAsyncSubject();
+        testParallelNotify();
+        testMailboxObserver();
 #endif
 
         testCopyCtor2DuringNotify1();
@@ -814,30 +1185,40 @@ public:
         printf("*** ::testAttachDetachAllAttachDuringNotify passed\n");
     }
 
-    void testCopyCtor()
+    void testDetachManyKeepsOrder()
     {
-        size_t expectedResult[] = { 2,3,4,5,7 };
+        size_t expectedResult[] =
+        {
+            1,11,21,31,41,51,
+            2,   22,   42,
+            3,   23,   43,53,13,
+        };
 
         tSubjectTestClass source;
-        tObserverTestClass listener(0);
+        tObserverTestClass listenerA(0);
+        tObserverTestClass listenerB(10);
+        tObserverTestClass listenerC(20);
+        tObserverTestClass listenerD(30);
+        tObserverTestClass listenerE(40);
+        tObserverTestClass listenerF(50);
 
         tSTNotifications.clear();
 
+        source.attach(&listenerA);
+        source.attach(&listenerB);
+        source.attach(&listenerC);
+        source.attach(&listenerD);
+        source.attach(&listenerE);
+        source.attach(&listenerF);
         source.notify(1);
-        source.attach(&listener);
+        source.detach(&listenerB);
+        source.detach(&listenerD);
+        source.detach(&listenerF);
         source.notify(2);
+        source.attach(&listenerF);
+        source.attach(&listenerB);
         source.notify(3);
-
-        tSubjectTestClass source2 = source;
-
-        source.notify(4);
-        source2.notify(5);
-        source.detach(&listener);
-        source.notify(6);
-        source2.notify(7);
-        source2.detach(&listener);
-        source.notify(8);
-        source2.notify(9);
+        source.detachAll();
 
         assert(tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t));
 
@@ -849,23 +1230,822 @@ public:
             }
         }
 
-        printf("*** ::testCopyCtor passed\n");
+        printf("*** ::testDetachManyKeepsOrder passed\n");
     }
 
-    void testCopyAssign()
+    void testInlineStorage()
     {
-        size_t expectedResult[]  = { 3,54,5,56,7,8,10 };
+        size_t expectedResult[] =
+        {
+            1,11,
+            2,12,22,
+              13,23,
+              14,24,
+        };
 
-        tSubjectTestClass source;
-        tSubjectTestClass source2;
-        tObserverTestClass listener(0);
-        tObserverTestClass listener2(50);
+        tSubject<const size_t&, 2>* source = new tSubject<const size_t&, 2>;
+        tObserverTestClass listenerA(0);
+        tObserverTestClass listenerB(10);
+        tObserverTestClass listenerC(20);
 
         tSTNotifications.clear();
 
-        source.notify(1);
-        source2.notify(2);
-        source.attach(&listener);
+        source->attach(&listenerA);
+        source->attach(&listenerB);
+        source->notify(1);
+        source->attach(&listenerC);
+        source->notify(2);
+        source->detach(&listenerA);
+        source->notify(3);
+
+        tSubject<const size_t&, 2> source2 = *source;
+        delete source;
+
+        source2.notify(4);
+
+        assert(tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t));
+
+        if (tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t))
+        {
+            for (size_t i = 0; i < sizeof(expectedResult) / sizeof(size_t); i++)
+            {
+                assert(tSTNotifications[i] == expectedResult[i]);
+            }
+        }
+
+        printf("*** ::testInlineStorage passed\n");
+    }
+
+    void testIsAttached()
+    {
+        tSubjectTestClass source;
+        tSubjectTestClass source2;
+        std::vector<tObserverTestClass*> listeners;
+
+        for (size_t i = 0; i < 1000; i++)
+        {
+            listeners.push_back(new tObserverTestClass(i));
+            source.attach(listeners.back());
+        }
+
+        source2.attach(listeners[10]);
+
+        assert(source.isAttached(listeners[0]));
+        assert(source.isAttached(listeners[999]));
+        assert(source2.isAttached(listeners[10]));
+        assert(!source2.isAttached(listeners[11]));
+
+        for (size_t i = 0; i < 1000; i += 2)
+        {
+            source.detach(listeners[i]);
+        }
+
+        assert(!source.isAttached(listeners[0]));
+        assert(source.isAttached(listeners[1]));
+        assert(source.isAttached(listeners[999]));
+        assert(source2.isAttached(listeners[10]));
+
+        for (size_t i = 0; i < 1000; i++)
+        {
+            delete listeners[i];
+        }
+
+        printf("*** ::testIsAttached passed\n");
+    }
+
+    void testAllocator()
+    {
+        size_t expectedResult[] = { 1,11,21,31,41, 12,32 };
+
+        tCountingAllocatorTestClass allocator;
+
+        {
+            tSubjectTestClass source;
+            tObserverTestClass listenerA(0);
+            tObserverTestClass listenerB(10);
+            tObserverTestClass listenerC(20);
+            tObserverTestClass listenerD(30);
+            tObserverTestClass listenerE(40);
+
+            tSTNotifications.clear();
+
+            source.attach(&listenerA);
+            source.setAllocator(&allocator);
+            listenerB.setAllocator(&allocator);
+
+            source.attach(&listenerB);
+            source.attach(&listenerC);
+            source.attach(&listenerD);
+            source.attach(&listenerE);
+            source.notify(1);
+
+            source.detach(&listenerA);
+            source.detach(&listenerC);
+            source.detach(&listenerE);
+            source.notify(2);
+
+            assert(allocator.mAllocations > 0);
+            assert(allocator.mOutstanding == 2);
+        }
+
+        assert(allocator.mOutstanding == 0);
+        assert(tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t));
+
+        if (tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t))
+        {
+            for (size_t i = 0; i < sizeof(expectedResult) / sizeof(size_t); i++)
+            {
+                assert(tSTNotifications[i] == expectedResult[i]);
+            }
+        }
+
+        printf("*** ::testAllocator passed\n");
+    }
+
+    void testBulkAttachDetach()
+    {
+        size_t expectedResult[] =
+        {
+            1,11,21,31,
+              12,   32,
+            3,   23,
+        };
+
+        tSubjectTestClass source;
+        tObserverTestClass listenerA(0);
+        tObserverTestClass listenerB(10);
+        tObserverTestClass listenerC(20);
+        tObserverTestClass listenerD(30);
+        tObserverTestClass* listeners[] = { &listenerA, &listenerB, &listenerC, &listenerD };
+
+        tSTNotifications.clear();
+
+        source.attach(listeners, listeners + 4);
+        source.notify(1);
+        source.detach(listeners, listeners + 4);
+        source.attach(&listenerB);
+        source.attach(&listenerD);
+        source.notify(2);
+        source.detach(listeners + 1, listeners + 2);
+        source.detach(listeners + 3, listeners + 4);
+        source.attach(listeners, listeners + 1);
+        source.attach(listeners + 2, listeners + 3);
+        source.notify(3);
+        source.detachAll();
+
+        assert(tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t));
+
+        if (tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t))
+        {
+            for (size_t i = 0; i < sizeof(expectedResult) / sizeof(size_t); i++)
+            {
+                assert(tSTNotifications[i] == expectedResult[i]);
+            }
+        }
+
+        printf("*** ::testBulkAttachDetach passed\n");
+    }
+
+    void testNotifyDuringNotify()
+    {
+        size_t expectedResult[] =
+        {
+            1,101,11,
+            2,102,12,
+            3,103,13,
+        };
+
+        tSubjectTestClass source;
+        tObserverTestClass listenerA(0);
+        NotifyDuringNotify renotify(&source, 3);
+        tObserverTestClass listenerB(10);
+
+        tSTNotifications.clear();
+
+        source.setQueueNestedNotify(true);
+        source.attach(&listenerA);
+        source.attach(&renotify);
+        source.attach(&listenerB);
+        source.notify(1);
+
+        assert(tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t));
+
+        if (tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t))
+        {
+            for (size_t i = 0; i < sizeof(expectedResult) / sizeof(size_t); i++)
+            {
+                assert(tSTNotifications[i] == expectedResult[i]);
+            }
+        }
+
+        printf("*** ::testNotifyDuringNotify passed\n");
+    }
+
+    void testNotifyCopies()
+    {
+        size_t expectedResult[] = { 1,1, 2,2, 3,3, 4,4, };
+
+        tSubject<const tCopyCountingMessage&> byRefSource;
+        tSubject<tCopyCountingMessage> byValueSource;
+        tCopyCountingByRefObserver byRefA, byRefB;
+        tCopyCountingByValueObserver byValueA, byValueB;
+        tCopyCountingMessage msg(3);
+
+        tSTNotifications.clear();
+
+        byRefSource.attach(&byRefA);
+        byRefSource.attach(&byRefB);
+        byValueSource.attach(&byValueA);
+        byValueSource.attach(&byValueB);
+
+        tCopyCountingMessage::sCopies = 0;
+        byRefSource.notify(tCopyCountingMessage(1));
+#if __cplusplus >= 201103L
+        byRefSource.emplaceNotify(2);
+#else
+        byRefSource.notify(tCopyCountingMessage(2));
+#endif
+        assert(tCopyCountingMessage::sCopies == 0);
+
+        // One copy per observer, made by update's by-value parameter, and none on the way there
+        byValueSource.notify(msg);
+        assert(tCopyCountingMessage::sCopies == 2);
+
+#if __cplusplus >= 201103L
+        byValueSource.emplaceNotify(4);
+#else
+        byValueSource.notify(tCopyCountingMessage(4));
+#endif
+        assert(tCopyCountingMessage::sCopies == 4);
+
+        assert(tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t));
+
+        if (tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t))
+        {
+            for (size_t i = 0; i < sizeof(expectedResult) / sizeof(size_t); i++)
+            {
+                assert(tSTNotifications[i] == expectedResult[i]);
+            }
+        }
+
+        printf("*** ::testNotifyCopies passed\n");
+    }
+
+    void testNotifyBatch()
+    {
+        size_t expectedResult[] =
+        {
+            11,12,13,
+            1006,
+            101,102,103,
+            4,24,104,
+            999,2,3,
+        };
+
+        tSubject<const size_t&> source;
+        tObserverTestClass listenerA(10);
+        tBatchObserverTestClass listenerB;
+        tObserverTestClass listenerC(20);
+        size_t batch[] = { 1, 2, 3 };
+
+        tSTNotifications.clear();
+
+        source.attach(&listenerA);
+        source.attach(&listenerB);
+        source.connect(&tSTCallbackFunction);
+
+        source.notifyBatch(batch, 3);
+
+        source.detach(&listenerA);
+        source.attach(&listenerC);
+        source.notifyBatch(batch + 3, 0);
+        source.notify(4);
+
+        // Detaching or deleting partway through a batch stops delivery right there, as it would with notify
+        tSubject<const size_t&>* doomed = new tSubject<const size_t&>();
+        tDetachObserverOnUpdateTestClass selfDetacher(doomed, &selfDetacher);
+        tDeleteSubjectOnUpdateTestClass deleter(doomed);
+
+        doomed->attach(&selfDetacher);
+        doomed->attach(&deleter);
+        doomed->attach(&listenerA);
+        doomed->notifyBatch(batch, 3);
+
+        // What an override passes on to the default updateBatch() is all that gets delivered
+        tSubject<const size_t&> partialSource;
+        tPartialBatchObserverTestClass partial;
+
+        partialSource.attach(&partial);
+        partialSource.notifyBatch(batch, 3);
+
+#if __cplusplus >= 201103L
+        // A callable moving the subject away partway through a batch ends the run for it too
+        tSubject<const size_t&> movedFrom, movedTo;
+        tSubject<const size_t&>* movedFromPtr = &movedFrom;
+        tSubject<const size_t&>* movedToPtr = &movedTo;
+        size_t moveCalls = 0;
+        size_t* moveCallsPtr = &moveCalls;
+
+        movedFrom.connect([movedFromPtr, movedToPtr, moveCallsPtr](const size_t&)
+        {
+            (*moveCallsPtr)++;
+            *movedToPtr = std::move(*movedFromPtr);
+        });
+
+        movedFrom.notifyBatch(batch, 3);
+        assert(moveCalls == 1);
+#endif
+
+        assert(tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t));
+
+        if (tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t))
+        {
+            for (size_t i = 0; i < sizeof(expectedResult) / sizeof(size_t); i++)
+            {
+                assert(tSTNotifications[i] == expectedResult[i]);
+            }
+        }
+
+        printf("*** ::testNotifyBatch passed\n");
+    }
+
+    void testConnect()
+    {
+        size_t expectedResult[] =
+        {
+            11,101,201,301,
+            12,102,302,
+            104,
+        };
+
+        tSubject<const size_t&> source;
+        tObserverTestClass listenerA(10);
+        tCallbackTargetTestClass target(200);
+        size_t base = 300;
+
+        tSTNotifications.clear();
+
+        source.attach(&listenerA);
+
+        tConnection functionConnection = source.connect(&tSTCallbackFunction);
+        tConnection methodConnection = source.connect(&target, &tCallbackTargetTestClass::record);
+#if __cplusplus >= 201103L
+        tConnection callableConnection = source.connect([base](const size_t& msg) { tSTNotifications.push_back(msg + base); });
+#else
+        tConnection callableConnection = source.connect(tCallbackFunctorTestClass(base));
+#endif
+
+        assert(functionConnection.connected() && methodConnection.connected() && callableConnection.connected());
+
+        source.notify(1);
+
+        source.disconnect(methodConnection);
+        assert(!methodConnection.connected());
+
+        source.notify(2);
+
+        source.detachAll();
+        source.notify(3);
+
+        functionConnection = source.connect(tSTCallbackFunction);
+        source.notify(4);
+
+        assert(tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t));
+
+        if (tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t))
+        {
+            for (size_t i = 0; i < sizeof(expectedResult) / sizeof(size_t); i++)
+            {
+                assert(tSTNotifications[i] == expectedResult[i]);
+            }
+        }
+
+        printf("*** ::testConnect passed\n");
+    }
+
+    void testKeyedSubject()
+    {
+        size_t expectedResult[] =
+        {
+            111,
+            122,132,
+            221,
+        };
+
+        tKeyedSubject<const size_t&, size_t, tKeyOfTestClass> source;
+        tObserverTestClass listenerA(100);
+        tObserverTestClass listenerB(110);
+        tObserverTestClass listenerC(200);
+
+        tSTNotifications.clear();
+
+        source.attach(1, &listenerA);
+        source.attach(2, &listenerA);
+        source.attach(2, &listenerB);
+        source.attach(1, &listenerC);
+
+        assert(source.isAttached(2, &listenerB));
+        assert(!source.isAttached(1, &listenerB));
+        assert(!source.isAttached(3, &listenerB));
+
+        source.detach(1, &listenerC);
+
+        source.notify(11);
+        source.notify(22);
+        source.notify(33);
+
+        source.detachAll();
+        source.attach(1, &listenerC);
+        source.notify(21);
+
+        assert(tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t));
+
+        if (tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t))
+        {
+            for (size_t i = 0; i < sizeof(expectedResult) / sizeof(size_t); i++)
+            {
+                assert(tSTNotifications[i] == expectedResult[i]);
+            }
+        }
+
+        printf("*** ::testKeyedSubject passed\n");
+    }
+
+    void testPrioritySubject()
+    {
+        size_t expectedResult[] =
+        {
+            21,51,11,31,41,
+            52,12,32,42,102,
+        };
+
+        tPrioritySubject<const size_t&> source;
+        tObserverTestClass listenerA(10);
+        tObserverTestClass listenerB(20);
+        tObserverTestClass listenerC(30);
+        tObserverTestClass listenerD(40);
+        tObserverTestClass listenerE(50);
+
+        tSTNotifications.clear();
+
+        source.attach(&listenerA);
+        source.attach(&listenerB, 10);
+        source.attach(&listenerC, 0);
+        source.attach(&listenerD, -5);
+        source.attach(&listenerE, 10);
+
+        assert(source.isAttached(&listenerD));
+
+        source.notify(1);
+
+        source.detach(&listenerB);
+        assert(!source.isAttached(&listenerB));
+
+        tConnection connection = source.connect(&tSTCallbackFunction, -10);
+        source.notify(2);
+
+        source.disconnect(connection, -10);
+        source.detachAll();
+        source.notify(3);
+
+        assert(tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t));
+
+        if (tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t))
+        {
+            for (size_t i = 0; i < sizeof(expectedResult) / sizeof(size_t); i++)
+            {
+                assert(tSTNotifications[i] == expectedResult[i]);
+            }
+        }
+
+        printf("*** ::testPrioritySubject passed\n");
+    }
+
+    void testConflatingSubject()
+    {
+        size_t expectedResult[] =
+        {
+            141,112,
+            125,
+        };
+
+        tConflatingSubject<const size_t&, size_t, tKeyOfTestClass> source;
+        tObserverTestClass listenerA(100);
+
+        tSTNotifications.clear();
+
+        source.attach(&listenerA);
+
+        source.notify(11);
+        source.notify(21);
+        source.notify(32);
+        source.notify(41);
+#if __cplusplus >= 201103L
+        source.emplaceNotify(size_t(12));
+#else
+        source.notify(12);
+#endif
+
+        assert(tSTNotifications.empty());
+        assert(source.pending() == 2);
+
+        source.flush();
+        assert(source.pending() == 0);
+        source.flush();
+
+        // A batch is conflated along with everything else
+        const size_t batch[] = { 15, 25 };
+
+        source.notify(5);
+        source.notifyBatch(batch, 2);
+        source.flush();
+
+        // Deleted from within update(); flush() stops there, and the other key goes undelivered
+        typedef tConflatingSubject<const size_t&, size_t, tKeyOfTestClass> DoomedType;
+
+        DoomedType* doomed = new DoomedType;
+        tDeleteOnUpdateTestClass<DoomedType> deleter(doomed);
+
+        doomed->attach(&deleter);
+        doomed->notify(1);
+        doomed->notify(2);
+        doomed->flush();
+
+        assert(tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t));
+
+        if (tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t))
+        {
+            for (size_t i = 0; i < sizeof(expectedResult) / sizeof(size_t); i++)
+            {
+                assert(tSTNotifications[i] == expectedResult[i]);
+            }
+        }
+
+        printf("*** ::testConflatingSubject passed\n");
+    }
+
+#if __cplusplus >= 201703L
+    void testStaticSubject()
+    {
+        size_t expectedResult[] =
+        {
+            1,11,
+            2,12,22,
+            3,13,
+            4,14,24,
+            5,6,15,16,25,26,
+            101,21,102,22,
+        };
+
+        tStaticHandlerTestClass handlerA(0);
+        tObserverTestClass handlerB(10);
+        tObserverTestClass listenerC(20);
+        tStaticSubject<const size_t&, tStaticHandlerTestClass, tObserverTestClass> source(handlerA, handlerB);
+
+        tSTNotifications.clear();
+
+        source.notify(1);
+        source.attach(&listenerC);
+        source.notify(2);
+        source.detach(&listenerC);
+        source.notify(3);
+
+        // The other entry points reach the static observers too
+        const size_t batch[] = { 5, 6 };
+
+        source.attach(&listenerC);
+        source.emplaceNotify(size_t(4));
+        source.notifyBatch(batch, 2);
+
+        // Notified through the base class, by a static observer that queues a second message; each message reaches the
+        // static and then the attached observers before the next one starts
+        NotifyDuringNotify renotify(NULL, 2);
+        tStaticSubject<const size_t&, NotifyDuringNotify> nested(renotify);
+        tSubject<const size_t&>& nestedBase = nested;
+
+        renotify.mSubject = &nested;
+        nested.setQueueNestedNotify(true);
+        nested.attach(&listenerC);
+        nestedBase.notify(1);
+
+        // Deleted by a static observer; neither form goes on to the observers after it
+        typedef tStaticSubject<const size_t&, tDeleteSubjectOnUpdateTestClass, tObserverTestClass> DoomedType;
+
+        for(size_t batched = 0; batched < 2; batched++)
+        {
+            tDeleteSubjectOnUpdateTestClass deleter;
+            tObserverTestClass after(30);
+            DoomedType* doomed = new DoomedType(deleter, after);
+
+            deleter.reset(doomed);
+            doomed->attach(&listenerC);
+
+            if (batched)
+            {
+                doomed->notifyBatch(batch, 2);
+            }
+            else
+            {
+                doomed->notify(1);
+            }
+        }
+
+        assert(tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t));
+
+        if (tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t))
+        {
+            for (size_t i = 0; i < sizeof(expectedResult) / sizeof(size_t); i++)
+            {
+                assert(tSTNotifications[i] == expectedResult[i]);
+            }
+        }
+
+        printf("*** ::testStaticSubject passed\n");
+    }
+#endif
+
+#if __cplusplus >= 201703L
+    void testVariantSubject()
+    {
+        size_t expectedResult[] =
+        {
+            11,
+            2,
+            13,103,
+            4,
+            5,
+        };
+
+        tVariantSubject<size_t, tCopyCountingMessage> source;
+        tObserverTestClass listenerA(10);
+        tCopyCountingByRefObserver listenerB;
+
+        tSTNotifications.clear();
+
+        source.attach(&listenerA);
+        source.attach(&listenerB);
+
+        assert(source.isAttached(&listenerA) && source.isAttached(&listenerB));
+
+        source.notify(tVariantSubject<size_t, tCopyCountingMessage>::VariantType(size_t(1)));
+        source.notify(tVariantSubject<size_t, tCopyCountingMessage>::VariantType(tCopyCountingMessage(2)));
+
+        tConnection connection = source.connect<size_t>(&tSTCallbackFunction);
+        source.notify(size_t(3));
+        source.notify(tCopyCountingMessage(4));
+
+        source.disconnect<size_t>(connection);
+        source.detach(&listenerA);
+        source.notify(size_t(5));
+        source.notify(tCopyCountingMessage(5));
+
+        assert(tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t));
+
+        if (tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t))
+        {
+            for (size_t i = 0; i < sizeof(expectedResult) / sizeof(size_t); i++)
+            {
+                assert(tSTNotifications[i] == expectedResult[i]);
+            }
+        }
+
+        printf("*** ::testVariantSubject passed\n");
+    }
+#endif
+
+#if __cplusplus >= 202002L
+    void testAwaitableSubject()
+    {
+        size_t expectedResult[] =
+        {
+            101,11,21,
+            102,12,22,
+            103,13,
+            104,
+            7,8,9,10,
+            101,11,102,12,
+            1,
+        };
+
+        tAwaitableSubject<const size_t&> source(4);
+        tObserverTestClass listenerA(100);
+
+        tSTNotifications.clear();
+
+        source.attach(&listenerA);
+
+        tSTAwaitMessages(source, 10, 3);
+        tSTAwaitMessages(source, 20, 2);
+
+        // Waiting consumers see each message of a batch in turn
+        const size_t batch[] = { 2, 3 };
+
+        source.notify(1);
+        source.notifyBatch(batch, 2);
+        source.emplaceNotify(size_t(4));
+
+        source.detach(&listenerA);
+
+        // Read later than notified: only the last four are still in the ring
+        tAwaitableSubject<const size_t&>::Cursor cursor(source);
+
+        for(size_t i = 5; i <= 10; i++)
+        {
+            source.notify(i);
+        }
+
+        tSTAwaitCursor(cursor, 4);
+        assert(cursor.missed() == 2);
+
+        // Notified through the base class, with a second message queued from within update; consumers see both, in order
+        tAwaitableSubject<const size_t&> nested;
+        tSubject<const size_t&>& nestedBase = nested;
+        NotifyDuringNotify renotify(&nested, 2);
+
+        nested.setQueueNestedNotify(true);
+        nested.attach(&renotify);
+
+        tSTAwaitMessages(nested, 10, 2);
+        nestedBase.notify(1);
+
+        // Deleted by an observer, and then by a resumed consumer; notify() stops there either way
+        tAwaitableSubject<const size_t&>* doomed = new tAwaitableSubject<const size_t&>;
+        tDeleteSubjectOnUpdateTestClass deleter(doomed);
+
+        doomed->attach(&deleter);
+        doomed->notifyBatch(batch, 2);
+
+        doomed = new tAwaitableSubject<const size_t&>;
+
+        tSTAwaitThenDelete(doomed);
+        doomed->notify(1);
+
+        assert(tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t));
+
+        if (tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t))
+        {
+            for (size_t i = 0; i < sizeof(expectedResult) / sizeof(size_t); i++)
+            {
+                assert(tSTNotifications[i] == expectedResult[i]);
+            }
+        }
+
+        printf("*** ::testAwaitableSubject passed\n");
+    }
+#endif
+
+    void testCopyCtor()
+    {
+        size_t expectedResult[] = { 2,3,4,5,7 };
+
+        tSubjectTestClass source;
+        tObserverTestClass listener(0);
+
+        tSTNotifications.clear();
+
+        source.notify(1);
+        source.attach(&listener);
+        source.notify(2);
+        source.notify(3);
+
+        tSubjectTestClass source2 = source;
+
+        source.notify(4);
+        source2.notify(5);
+        source.detach(&listener);
+        source.notify(6);
+        source2.notify(7);
+        source2.detach(&listener);
+        source.notify(8);
+        source2.notify(9);
+
+        assert(tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t));
+
+        if (tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t))
+        {
+            for (size_t i = 0; i < sizeof(expectedResult) / sizeof(size_t); i++)
+            {
+                assert(tSTNotifications[i] == expectedResult[i]);
+            }
+        }
+
+        printf("*** ::testCopyCtor passed\n");
+    }
+
+    void testCopyAssign()
+    {
+        size_t expectedResult[]  = { 3,54,5,56,7,8,10 };
+
+        tSubjectTestClass source;
+        tSubjectTestClass source2;
+        tObserverTestClass listener(0);
+        tObserverTestClass listener2(50);
+
+        tSTNotifications.clear();
+
+        source.notify(1);
+        source2.notify(2);
+        source.attach(&listener);
         source2.attach(&listener2);
         source.notify(3);
         source2.notify(4);
@@ -972,6 +2152,472 @@ public:
 
         printf("*** ::testMoveAssign passed\n");
     }
+
+    void testMoveInVector()
+    {
+        size_t expectedResult[] = { 1,11, 2,12, 3, 4,14, 5 };
+
+        std::vector<tSubject<const size_t&> > sources(1);
+        tObserverTestClass listenerA(0);
+        tObserverTestClass listenerB(10);
+
+        tSTNotifications.clear();
+
+        sources[0].attach(&listenerA);
+        sources[0].attach(&listenerB);
+        sources[0].notify(1);
+
+        // Reallocation moves the subject; its observers must follow without being re-attached
+        for (size_t i = 0; i < 64; i++)
+        {
+            sources.push_back(tSubject<const size_t&>());
+        }
+
+        sources[0].notify(2);
+        sources[0].detach(&listenerB);
+        sources[0].notify(3);
+        sources[1].attach(&listenerA);
+        sources[1].attach(&listenerB);
+        sources.erase(sources.begin());
+        sources[0].notify(4);
+        sources.clear();
+        sources.resize(1);
+        sources[0].attach(&listenerA);
+        sources[0].notify(5);
+
+        assert(tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t));
+
+        if (tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t))
+        {
+            for (size_t i = 0; i < sizeof(expectedResult) / sizeof(size_t); i++)
+            {
+                assert(tSTNotifications[i] == expectedResult[i]);
+            }
+        }
+
+        printf("*** ::testMoveInVector passed\n");
+    }
+
+    void testConcurrentSubject()
+    {
+        size_t expectedResult[] =
+        {
+            11,21,
+            12,
+        };
+
+        tConcurrentSubject<const size_t&> source;
+        tObserverTestClass listenerA(10);
+        tObserverTestClass listenerB(20);
+
+        tSTNotifications.clear();
+
+        source.attach(&listenerA);
+        source.attach(&listenerB);
+        source.notify(1);
+
+        source.detach(&listenerB);
+        assert(!source.isAttached(&listenerB));
+        source.notify(2);
+
+        source.detachAll();
+        source.notify(3);
+
+        assert(tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t));
+
+        if (tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t))
+        {
+            for (size_t i = 0; i < sizeof(expectedResult) / sizeof(size_t); i++)
+            {
+                assert(tSTNotifications[i] == expectedResult[i]);
+            }
+        }
+
+        // Notifying from several threads while another attaches and detaches; the steady observer sees every message,
+        // and one that's been detached sees nothing more
+        tCountingObserverTestClass steady, churning;
+        const size_t threadCount = 4, notifyCount = 10000;
+        std::vector<std::thread> threads;
+
+        source.attach(&steady);
+
+        for(size_t i = 0; i < threadCount; i++)
+        {
+            threads.push_back(std::thread([&source, notifyCount]()
+            {
+                for(size_t n = 0; n < notifyCount; n++)
+                {
+                    source.notify(1);
+                }
+            }));
+        }
+
+        for(size_t i = 0; i < 100; i++)
+        {
+            source.attach(&churning);
+            source.detach(&churning);
+        }
+
+        size_t churned = churning.mCount.load();
+
+        for(size_t i = 0; i < threads.size(); i++)
+        {
+            threads[i].join();
+        }
+
+        assert(steady.mCount.load() == threadCount * notifyCount);
+        assert(churning.mCount.load() == churned);
+
+        printf("*** ::testConcurrentSubject passed\n");
+    }
+
+    void testAsyncSubject()
+    {
+        size_t expectedResult[] =
+        {
+            11,12,13,
+            14,
+            15,16,17,18,
+        };
+
+        tAsyncSubject<const size_t&> source(4);
+        tObserverTestClass listenerA(10);
+
+        tSTNotifications.clear();
+
+        source.attach(&listenerA);
+
+        assert(source.notify(1));
+        assert(source.notify(2));
+        assert(source.notify(3));
+        assert(source.notify(4));
+        assert(!source.notify(5));
+        assert(tSTNotifications.empty());
+
+        assert(source.drain(3) == 3);
+        assert(source.drain() == 1);
+        assert(source.drain() == 0);
+
+        // The other entry points queue too, rather than delivering on this thread
+        const size_t batch[] = { 6, 7, 8, 9 };
+
+        assert(source.emplaceNotify(size_t(5)));
+        assert(source.notifyBatch(batch, 4) == 3);
+        assert(tSTNotifications.size() == 4);
+        assert(source.drain() == 4);
+
+        assert(tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t));
+
+        if (tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t))
+        {
+            for (size_t i = 0; i < sizeof(expectedResult) / sizeof(size_t); i++)
+            {
+                assert(tSTNotifications[i] == expectedResult[i]);
+            }
+        }
+
+        source.detach(&listenerA);
+
+        // Several producers at once, delivered by the dispatcher thread; a full ring is simply retried
+        tCountingObserverTestClass counter;
+        const size_t threadCount = 4, notifyCount = 10000;
+        std::vector<std::thread> threads;
+
+        source.attach(&counter);
+        source.start();
+
+        for(size_t i = 0; i < threadCount; i++)
+        {
+            bool emplace = (i % 2) != 0;
+
+            threads.push_back(std::thread([&source, notifyCount, emplace]()
+            {
+                for(size_t n = 0; n < notifyCount; n++)
+                {
+                    while (!(emplace ? source.emplaceNotify(size_t(1)) : source.notify(1)))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            }));
+        }
+
+        for(size_t i = 0; i < threads.size(); i++)
+        {
+            threads[i].join();
+        }
+
+        source.stop();
+
+        assert(counter.mCount.load() == threadCount * notifyCount);
+
+        // Left idle long enough for the dispatcher to go to sleep; a notify wakes it, well before stop() would drain
+        source.start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        assert(source.notify(1));
+
+        for(size_t i = 0; i < 2000 && counter.mCount.load() == threadCount * notifyCount; i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        assert(counter.mCount.load() == threadCount * notifyCount + 1);
+
+        source.stop();
+
+        // Deleted from within update() during a drain() of our own; drain() stops there, and the rest goes undelivered
+        tAsyncSubject<const size_t&>* doomed = new tAsyncSubject<const size_t&>(4);
+        tDeleteOnUpdateTestClass<tAsyncSubject<const size_t&> > deleter(doomed);
+
+        doomed->attach(&deleter);
+        doomed->notify(1);
+        doomed->notify(2);
+
+        assert(doomed->drain() == 1);
+
+        printf("*** ::testAsyncSubject passed\n");
+    }
+
+    void testParallelNotify()
+    {
+        size_t expectedResult[] =
+        {
+            11,
+            12,
+            13,
+            14,
+            15,16,
+            101,21,102,22,
+            101,21,102,22,
+        };
+
+        tWorkStealingPool pool(3);
+        tParallelSubject<const size_t&> source;
+        tObserverTestClass listenerA(10);
+        std::vector<tCountingObserverTestClass> counters(1000);
+        tDetachConcurrentOnUpdateTestClass detacher(&source);
+
+        tSTNotifications.clear();
+
+        source.attach(&listenerA);
+
+        for(size_t i = 0; i < counters.size(); i++)
+        {
+            source.attachConcurrent(&counters[i]);
+        }
+
+        source.attachConcurrent(&detacher);
+
+        source.parallelNotify(pool, 1);
+        assert(!source.isAttachedConcurrent(&detacher));
+
+        source.parallelNotify(pool, 2);
+        source.notify(3);
+        source.emplaceNotify(size_t(4));
+
+        const size_t batch[] = { 5, 6 };
+
+        source.notifyBatch(batch, 2);
+
+        for(size_t i = 0; i < counters.size(); i++)
+        {
+            assert(counters[i].mCount.load() == 21);
+        }
+
+        assert(detacher.mCount.load() == 1);
+
+        // A message queued from within update reaches the concurrent observers after the one before it, whether the
+        // pass was started through the base class or by parallelNotify; a single observer means a single chunk
+        tParallelSubject<const size_t&> nested;
+        tSubject<const size_t&>& nestedBase = nested;
+        NotifyDuringNotify renotify(&nested, 2);
+        tObserverTestClass concurrent(20);
+
+        nested.setQueueNestedNotify(true);
+        nested.attach(&renotify);
+        nested.attachConcurrent(&concurrent);
+
+        nestedBase.notify(1);
+        nested.parallelNotify(pool, 1);
+
+        assert(tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t));
+
+        if (tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t))
+        {
+            for (size_t i = 0; i < sizeof(expectedResult) / sizeof(size_t); i++)
+            {
+                assert(tSTNotifications[i] == expectedResult[i]);
+            }
+        }
+
+        // Detached during the parallel phase by an observer earlier in its chunk; it's skipped straight away
+        tParallelSubject<const size_t&> small;
+        tCountingObserverTestClass victim;
+        tDetachConcurrentOnUpdateTestClass victimDetacher(&small, &victim);
+
+        small.attachConcurrent(&victimDetacher);
+        small.attachConcurrent(&victim);
+        small.parallelNotify(pool, 1);
+
+        assert(victim.mCount.load() == 0);
+        assert(!small.isAttachedConcurrent(&victim));
+
+        // An ordinary observer deleting the subject; neither form goes on to the concurrent observers
+        for(size_t parallel = 0; parallel < 2; parallel++)
+        {
+            tParallelSubject<const size_t&>* doomed = new tParallelSubject<const size_t&>;
+            tDeleteSubjectOnUpdateTestClass deleter(doomed);
+            tCountingObserverTestClass counter;
+
+            doomed->attach(&deleter);
+            doomed->attachConcurrent(&counter);
+
+            if (parallel)
+            {
+                doomed->parallelNotify(pool, 1);
+            }
+            else
+            {
+                doomed->notify(1);
+            }
+
+            assert(counter.mCount.load() == 0);
+        }
+
+        printf("*** ::testParallelNotify passed\n");
+    }
+
+    void testMailboxObserver()
+    {
+        size_t expectedResult[] =
+        {
+            1,2,3,4,
+            7,
+        };
+
+        tSubject<const size_t&> source;
+        tMailboxTestClass mailbox(4, true);
+
+        tSTNotifications.clear();
+
+        source.attach(&mailbox);
+
+        for(size_t i = 1; i <= 6; i++)
+        {
+            source.notify(i);
+        }
+
+        assert(tSTNotifications.empty());
+        assert(mailbox.dropped() == 2);
+        assert(mailbox.drain() == 4);
+
+        source.notify(7);
+        assert(mailbox.drain() == 1);
+        assert(mailbox.drain() == 0);
+
+        assert(tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t));
+
+        if (tSTNotifications.size() == sizeof(expectedResult) / sizeof(size_t))
+        {
+            for (size_t i = 0; i < sizeof(expectedResult) / sizeof(size_t); i++)
+            {
+                assert(tSTNotifications[i] == expectedResult[i]);
+            }
+        }
+
+        // Notified on one thread, updated on this one; everything is either delivered, in order, or counted as dropped
+        tSubject<const size_t&> producer;
+        tMailboxTestClass worker(64, false);
+        const size_t notifyCount = 20000;
+
+        producer.attach(&worker);
+
+        std::thread producerThread([&producer, notifyCount]()
+        {
+            for(size_t n = 1; n <= notifyCount; n++)
+            {
+                producer.notify(n);
+            }
+        });
+
+        while (worker.mLast != notifyCount && worker.mCount + worker.dropped() != notifyCount)
+        {
+            worker.drain();
+        }
+
+        producerThread.join();
+        worker.drain();
+
+        assert(worker.mInOrder);
+        assert(worker.mCount + worker.dropped() == notifyCount);
+
+        // Two subjects on two threads at once, each with its own ring; each one's messages still arrive in order
+        tSubject<const size_t&> oddSource;
+        tSubject<const size_t&> evenSource;
+        tMailboxTestClass shared(64, false);
+
+        oddSource.attach(&shared);
+        evenSource.attach(&shared);
+
+        std::thread oddThread([&oddSource, notifyCount]()
+        {
+            for(size_t n = 1; n <= notifyCount; n += 2)
+            {
+                oddSource.notify(n);
+            }
+        });
+
+        std::thread evenThread([&evenSource, notifyCount]()
+        {
+            for(size_t n = 2; n <= notifyCount; n += 2)
+            {
+                evenSource.notify(n);
+            }
+        });
+
+        while (shared.mCount + shared.dropped() != notifyCount)
+        {
+            shared.drain();
+        }
+
+        oddThread.join();
+        evenThread.join();
+
+        assert(shared.drain() == 0);
+        assert(shared.mInOrder);
+        assert(shared.mCount + shared.dropped() == notifyCount);
+
+        // Short-lived subjects: each one's ring goes with it, along with whatever it left undelivered
+        for(size_t i = 0; i < 1000; i++)
+        {
+            tSubject<const size_t&> temporary;
+
+            temporary.attach(&mailbox);
+            temporary.notify(i + 100);
+        }
+
+        assert(mailbox.drain() == 0);
+
+        // Detached from within update() during drain(); the rest of that ring is dropped, and the next subject's drained
+        tSubject<const size_t&> leaving;
+        tSubject<const size_t&> staying;
+        tDetachingMailboxTestClass detaching(&leaving);
+
+        tSTNotifications.clear();
+
+        leaving.attach(&detaching);
+        staying.attach(&detaching);
+        leaving.notify(1);
+        leaving.notify(2);
+        staying.notify(3);
+
+        assert(detaching.drain() == 2);
+        assert(!leaving.isAttached(&detaching));
+        assert(tSTNotifications.size() == 2 && tSTNotifications[0] == 1 && tSTNotifications[1] == 3);
+
+        printf("*** ::testMailboxObserver passed\n");
+    }
 #endif
 
     void testCopyCtor2DuringNotify1()
@@ -0,0 +1,144 @@
+/*
+ Observer Template (C++) by TJ Grant (tjgrant@tatewake.com)
+
+ tVariantSubject: one subject carrying the alternatives of a std::variant.
+
+ //--
+
+ Copyright (c) 2011-02-01 TJ Grant (tjgrant@tatewake.com)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ and associated documentation files (the "Software"), to deal in the Software without restriction,
+ including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#pragma once
+
+#include "tObserver.h"
+
+#if __cplusplus >= 201703L
+#include <tuple>
+#include <utility>
+#include <variant>
+#endif
+
+#if __cplusplus >= 201703L
+// One object carrying several message types: a tSubject<const U&> per alternative U, attached to with the usual
+// observer types. Notifying with a std::variant<Ts...> jumps straight to the right subject through a table built at
+// compile time from the alternative's index; notifying with a U picks its subject at compile time.
+template<class... Ts>
+class tVariantSubject
+{
+public:
+    typedef std::variant<Ts...>     VariantType;
+
+private:
+    typedef void (*NotifyFunction)(tVariantSubject& subject, const VariantType& msg);
+
+    template<size_t I> static void NotifyAlternative(tVariantSubject& subject, const VariantType& msg);
+
+    template<class Indices> struct NotifyTable;
+
+    template<size_t... Is>
+    struct NotifyTable< std::index_sequence<Is...> >
+    {
+        static constexpr NotifyFunction kFunctions[] = { &tVariantSubject::NotifyAlternative<Is>... };
+    };
+
+private:
+    std::tuple< tSubject<const Ts&>... >    mSubjects;
+
+public:
+    template<class U> void attach(tObserver<const U&>* newOb);
+    template<class U> void detach(tObserver<const U&>* newOb);
+    void detachAll();
+
+    template<class U> tConnection connect(const tDelegate<const U&>& callback);
+    template<class U> void disconnect(tConnection& connection);
+
+    void notify(const VariantType& msg);
+    template<class U> void notify(const U& msg);
+
+    template<class U> bool isAttached(const tObserver<const U&>* ob) const;
+};
+#endif
+
+#if __cplusplus >= 201703L
+template<class... Ts>
+template<size_t I>
+void tVariantSubject<Ts...>::NotifyAlternative(tVariantSubject& subject, const VariantType& msg)
+{
+    std::get<I>(subject.mSubjects).notify(*std::get_if<I>(&msg));
+}
+
+template<class... Ts>
+template<class U>
+void tVariantSubject<Ts...>::attach(tObserver<const U&>* newOb)
+{
+    std::get< tSubject<const U&> >(mSubjects).attach(newOb);
+}
+
+template<class... Ts>
+template<class U>
+void tVariantSubject<Ts...>::detach(tObserver<const U&>* newOb)
+{
+    std::get< tSubject<const U&> >(mSubjects).detach(newOb);
+}
+
+template<class... Ts>
+void tVariantSubject<Ts...>::detachAll()
+{
+    std::apply([](tSubject<const Ts&>&... subjects) { (subjects.detachAll(), ...); }, mSubjects);
+}
+
+template<class... Ts>
+template<class U>
+tConnection tVariantSubject<Ts...>::connect(const tDelegate<const U&>& callback)
+{
+    return std::get< tSubject<const U&> >(mSubjects).connect(callback);
+}
+
+template<class... Ts>
+template<class U>
+void tVariantSubject<Ts...>::disconnect(tConnection& connection)
+{
+    std::get< tSubject<const U&> >(mSubjects).disconnect(connection);
+}
+
+template<class... Ts>
+void tVariantSubject<Ts...>::notify(const VariantType& msg)
+{
+    assert(!msg.valueless_by_exception());
+
+    if (!msg.valueless_by_exception())
+    {
+        NotifyTable< std::index_sequence_for<Ts...> >::kFunctions[msg.index()](*this, msg);
+    }
+}
+
+template<class... Ts>
+template<class U>
+void tVariantSubject<Ts...>::notify(const U& msg)
+{
+    std::get< tSubject<const U&> >(mSubjects).notify(msg);
+}
+
+template<class... Ts>
+template<class U>
+bool tVariantSubject<Ts...>::isAttached(const tObserver<const U&>* ob) const
+{
+    return std::get< tSubject<const U&> >(mSubjects).isAttached(ob);
+}
+#endif